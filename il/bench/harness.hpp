@@ -0,0 +1,59 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <iomanip>
+#include <string>
+
+// Minimal self-contained microbenchmark harness
+// A benchmark body receives an iteration count and is rerun with more iterations until it takes long enough
+namespace harness {
+    inline constexpr double MIN_SECONDS {0.25};
+
+    struct Measurement {
+        double seconds {};
+        std::size_t iterations {};
+    };
+
+    inline const void* volatile sink {nullptr};
+
+    // Prevent the compiler from discarding a result
+    template<typename T>
+    void keep(T&& value) {
+        sink = static_cast<const void*>(&value);
+    }
+
+    template<typename F>
+    Measurement measure(F&& body) {
+        std::size_t iterations {1u};
+
+        while (true) {
+            const auto start {std::chrono::steady_clock::now()};
+            body(iterations);
+            const auto end {std::chrono::steady_clock::now()};
+
+            const double seconds {std::chrono::duration<double>(end - start).count()};
+
+            if (seconds >= MIN_SECONDS || iterations >= (std::size_t(1u) << 40u)) {
+                return { seconds, iterations };
+            }
+
+            iterations *= seconds < MIN_SECONDS / 10.0 ? 10u : 2u;
+        }
+    }
+
+    // Report time per iteration and optionally a rate of units per second, given the units processed per iteration
+    inline void report(const std::string& name, const Measurement& measurement, double units = 0.0, const std::string& unit = {}) {
+        const double iterations {static_cast<double>(measurement.iterations)};
+
+        std::cout << std::left << std::setw(40) << name << std::right << std::fixed << std::setprecision(1)
+            << std::setw(14) << measurement.seconds / iterations * 1e9 << " ns/op";
+
+        if (units > 0.0) {
+            std::cout << std::setw(14) << std::setprecision(2) << units * iterations / measurement.seconds << ' ' << unit;
+        }
+
+        std::cout << '\n';
+    }
+}
@@ -0,0 +1,572 @@
+#include <string>
+#include <vector>
+#include <memory>
+#include <deque>
+#include <cstddef>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+
+#include "harness.hpp"
+#include "scanner.hpp"
+#include "parser.hpp"
+#include "analyzer.hpp"
+#include "front_end.hpp"
+#include "interpreter.hpp"
+#include "environment.hpp"
+#include "context.hpp"
+#include "object.hpp"
+#include "ast.hpp"
+#include "il.hpp"
+#include "embed.hpp"
+#include "program.hpp"
+
+using Statements = std::vector<std::shared_ptr<ast::stmt::Stmt<std::shared_ptr<object::Object>>>>;
+
+static const char* SOURCE_UNIT {
+R"(struct Human {
+    init(self, name, age, height) {
+        self.name = name;
+        self.age = age;
+        self.height = height;
+    }
+
+    is_adult(self) {
+        return self.age >= 18;
+    }
+}
+
+fun factorial(n) {
+    if (n < 2) {
+        return 1;
+    }
+
+    return factorial(n - 1) * n;  // Recursive
+}
+
+let sum = 0;
+
+for (let i = 0; i < 100; i = i + 1) {
+    let human = Human("Simon", i, 1.7);
+
+    if (human.is_adult() and not (i == 50)) {
+        sum = sum + factorial(i / 10) - 3;
+    } else {
+        sum = sum + int(2.5 * 4.0);
+    }
+}
+
+println("Done " + str(sum));
+)"
+};
+
+// Counts the nodes of a syntax tree; the trees are parsed with the node count as the visitors' return type
+class NodeCounter : ast::expr::Visitor<std::size_t>, ast::stmt::Visitor<std::size_t> {
+public:
+    std::size_t count(const std::vector<std::shared_ptr<ast::stmt::Stmt<std::size_t>>>& stmts) {
+        std::size_t result {0u};
+
+        for (const auto& stmt : stmts) {
+            result += count(stmt);
+        }
+
+        return result;
+    }
+private:
+    std::size_t count(const std::shared_ptr<ast::expr::Expr<std::size_t>>& expr) {
+        return expr != nullptr ? expr->accept(this) : 0u;
+    }
+
+    std::size_t count(const std::shared_ptr<ast::stmt::Stmt<std::size_t>>& stmt) {
+        return stmt != nullptr ? stmt->accept(this) : 0u;
+    }
+
+    std::size_t visit(ast::expr::Literal<std::size_t>*) override {
+        return 1u;
+    }
+
+    std::size_t visit(ast::expr::Grouping<std::size_t>* expr) override {
+        return 1u + count(expr->expression);
+    }
+
+    std::size_t visit(ast::expr::Unary<std::size_t>* expr) override {
+        return 1u + count(expr->right);
+    }
+
+    std::size_t visit(ast::expr::Binary<std::size_t>* expr) override {
+        return 1u + count(expr->left) + count(expr->right);
+    }
+
+    std::size_t visit(ast::expr::Variable<std::size_t>*) override {
+        return 1u;
+    }
+
+    std::size_t visit(ast::expr::Assignment<std::size_t>* expr) override {
+        return 1u + count(expr->value);
+    }
+
+    std::size_t visit(ast::expr::Logical<std::size_t>* expr) override {
+        return 1u + count(expr->left) + count(expr->right);
+    }
+
+    std::size_t visit(ast::expr::Call<std::size_t>* expr) override {
+        std::size_t result {1u + count(expr->callee)};
+
+        for (const auto& argument : expr->arguments) {
+            result += count(argument);
+        }
+
+        return result;
+    }
+
+    std::size_t visit(ast::expr::Get<std::size_t>* expr) override {
+        return 1u + count(expr->object);
+    }
+
+    std::size_t visit(ast::expr::Set<std::size_t>* expr) override {
+        return 1u + count(expr->object) + count(expr->value);
+    }
+
+    std::size_t visit(ast::expr::Array<std::size_t>* expr) override {
+        std::size_t result {1u};
+
+        for (const auto& element : expr->elements) {
+            result += count(element);
+        }
+
+        return result;
+    }
+
+    std::size_t visit(ast::expr::Index<std::size_t>* expr) override {
+        return 1u + count(expr->object) + count(expr->index);
+    }
+
+    std::size_t visit(ast::expr::IndexSet<std::size_t>* expr) override {
+        return 1u + count(expr->object) + count(expr->index) + count(expr->value);
+    }
+
+    std::size_t visit(ast::expr::MapLiteral<std::size_t>* expr) override {
+        std::size_t result {1u};
+
+        for (std::size_t i {0u}; i < expr->keys.size(); i++) {
+            result += count(expr->keys[i]) + count(expr->values[i]);
+        }
+
+        return result;
+    }
+
+    std::size_t visit(ast::expr::SetLiteral<std::size_t>* expr) override {
+        std::size_t result {1u};
+
+        for (const auto& element : expr->elements) {
+            result += count(element);
+        }
+
+        return result;
+    }
+
+    std::size_t visit(const ast::stmt::Expression<std::size_t>* stmt) override {
+        return 1u + count(stmt->expression);
+    }
+
+    std::size_t visit(const ast::stmt::Let<std::size_t>* stmt) override {
+        return 1u + count(stmt->initializer);
+    }
+
+    std::size_t visit(const ast::stmt::Function<std::size_t>* stmt) override {
+        return 1u + count(stmt->body);
+    }
+
+    std::size_t visit(const ast::stmt::Struct<std::size_t>* stmt) override {
+        std::size_t result {1u};
+
+        for (const auto& method : stmt->methods) {
+            result += method->accept(this);
+        }
+
+        return result;
+    }
+
+    std::size_t visit(const ast::stmt::If<std::size_t>* stmt) override {
+        return 1u + count(stmt->condition) + count(stmt->then_branch) + count(stmt->else_branch);
+    }
+
+    std::size_t visit(const ast::stmt::While<std::size_t>* stmt) override {
+        return 1u + count(stmt->condition) + count(stmt->body);
+    }
+
+    std::size_t visit(const ast::stmt::ForRange<std::size_t>* stmt) override {
+        return 1u + count(stmt->start) + count(stmt->stop) + count(stmt->step) + count(stmt->body);
+    }
+
+    std::size_t visit(const ast::stmt::Block<std::size_t>* stmt) override {
+        return 1u + count(stmt->statements);
+    }
+
+    std::size_t visit(const ast::stmt::Return<std::size_t>* stmt) override {
+        return 1u + count(stmt->value);
+    }
+};
+
+static std::string make_source(std::size_t units) {
+    std::string source;
+
+    for (std::size_t i {0u}; i < units; i++) {
+        source += SOURCE_UNIT;
+    }
+
+    return source;
+}
+
+static Statements compile(const std::string& source, Context* ctx) {
+    Scanner scanner {source, ctx};
+    Parser parser {scanner.scan(), ctx};
+
+    Statements statements {parser.parse<std::shared_ptr<object::Object>>()};
+
+    Analyzer analyzer {ctx};
+    analyzer.analyze(statements);
+
+    return statements;
+}
+
+static void bench_front_end() {
+    const std::string source {make_source(100u)};
+    const double megabytes {static_cast<double>(source.size()) / (1024.0 * 1024.0)};
+
+    Context ctx;
+
+    harness::report("Scanner::scan", harness::measure([&](std::size_t iterations) {
+        for (std::size_t i {0u}; i < iterations; i++) {
+            Scanner scanner {source, &ctx};
+            harness::keep(scanner.scan());
+        }
+    }), megabytes, "MB/s");
+
+    Scanner scanner {source, &ctx};
+    const std::vector<token::Token> tokens {scanner.scan()};
+
+    double nodes {};
+
+    {
+        Parser parser {tokens, &ctx};
+        nodes = static_cast<double>(NodeCounter().count(parser.parse<std::size_t>()));
+    }
+
+    harness::report("Parser::parse", harness::measure([&](std::size_t iterations) {
+        for (std::size_t i {0u}; i < iterations; i++) {
+            Parser parser {tokens, &ctx};
+            harness::keep(parser.parse<std::shared_ptr<object::Object>>());
+        }
+    }), nodes, "nodes/s");
+
+    // Only the braces of the function bodies are matched, so the rate is per node of the whole program
+    harness::report("Parser::parse lazy", harness::measure([&](std::size_t iterations) {
+        for (std::size_t i {0u}; i < iterations; i++) {
+            Parser parser {tokens, &ctx, true};
+            harness::keep(parser.parse<std::shared_ptr<object::Object>>());
+        }
+    }), nodes, "nodes/s");
+
+    Parser parser {tokens, &ctx};
+    const Statements statements {parser.parse<std::shared_ptr<object::Object>>()};
+
+    harness::report("Analyzer::analyze", harness::measure([&](std::size_t iterations) {
+        for (std::size_t i {0u}; i < iterations; i++) {
+            Analyzer analyzer {&ctx};
+            analyzer.analyze(statements);
+        }
+    }), nodes, "nodes/s");
+
+    // Scanning, parsing and analyzing together, cut into pieces at the top level
+    for (const unsigned int threads : {1u, 2u, 4u}) {
+        harness::report("front_end::compile on " + std::to_string(threads) + " threads", harness::measure([&](std::size_t iterations) {
+            for (std::size_t i {0u}; i < iterations; i++) {
+                harness::keep(front_end::compile(source, threads, false));
+            }
+        }), megabytes, "MB/s");
+    }
+}
+
+static void bench_environment() {
+    const token::Token name {token::TokenType::Identifier, "target", 1u};
+
+    for (const std::size_t depth : {1u, 4u, 16u, 64u}) {
+        std::deque<Environment> environments;
+        environments.emplace_back();
+        environments.back().define("target", object::create_integer(1ll));
+
+        for (std::size_t i {1u}; i < depth; i++) {
+            environments.emplace_back(&environments.back());
+
+            // Make every scope look like a real one
+            for (std::size_t j {0u}; j < 4u; j++) {
+                environments.back().define("local" + std::to_string(j), object::create_none());
+            }
+        }
+
+        const Environment& innermost {environments.back()};
+
+        harness::report("Environment::get depth " + std::to_string(depth), harness::measure([&](std::size_t iterations) {
+            for (std::size_t i {0u}; i < iterations; i++) {
+                harness::keep(innermost.get(name));
+            }
+        }));
+    }
+}
+
+static void bench_objects() {
+    harness::report("create_integer interned", harness::measure([](std::size_t iterations) {
+        for (std::size_t i {0u}; i < iterations; i++) {
+            harness::keep(object::create_integer(static_cast<long long>(i % 200u)));
+        }
+    }), 1.0, "objects/s");
+
+    harness::report("create_integer", harness::measure([](std::size_t iterations) {
+        for (std::size_t i {0u}; i < iterations; i++) {
+            harness::keep(object::create_integer(static_cast<long long>(i) + 1000ll));
+        }
+    }), 1.0, "objects/s");
+
+    harness::report("create_float", harness::measure([](std::size_t iterations) {
+        for (std::size_t i {0u}; i < iterations; i++) {
+            harness::keep(object::create_float(static_cast<double>(i)));
+        }
+    }), 1.0, "objects/s");
+
+    harness::report("create_string", harness::measure([](std::size_t iterations) {
+        for (std::size_t i {0u}; i < iterations; i++) {
+            harness::keep(object::create_string("a string longer than the small buffer"));
+        }
+    }), 1.0, "objects/s");
+
+    harness::report("create_bool", harness::measure([](std::size_t iterations) {
+        for (std::size_t i {0u}; i < iterations; i++) {
+            harness::keep(object::create_bool(i % 2u == 0u));
+        }
+    }), 1.0, "objects/s");
+
+    auto struct_ {object::cast<object::Struct>(object::create_struct("S", {}))};
+    auto instance {object::cast<object::StructInstance>(object::create_struct_instance(struct_))};
+
+    for (const char* field : {"name", "age", "height", "weight"}) {
+        instance->set(token::Token(token::TokenType::Identifier, field, 1u), object::create_integer(1ll));
+    }
+
+    const token::Token field {token::TokenType::Identifier, "height", 1u};
+
+    harness::report("StructInstance::get", harness::measure([&](std::size_t iterations) {
+        for (std::size_t i {0u}; i < iterations; i++) {
+            harness::keep(instance->get(field));
+        }
+    }));
+}
+
+static void bench_calls() {
+    std::ostream null_stream {nullptr};
+
+    Context ctx;
+    Interpreter interpreter {&ctx, &null_stream};
+
+    interpreter.interpret(compile("fun identity(x) { return x; } fun nothing(x) {}", &ctx));
+
+    const token::Token paren {token::TokenType::RightParen, ")", 1u};
+    const std::vector<std::shared_ptr<object::Object>> arguments {object::create_integer(1ll)};
+
+    for (const char* name : {"identity", "nothing", "str"}) {
+        auto callee {interpreter.get_global_environment().get(token::Token(token::TokenType::Identifier, name, 1u))};
+
+        object::Callable* callable {nullptr};
+
+        if (callee->type == object::Type::Function) {
+            callable = object::cast<object::Function>(callee).get();
+        } else {
+            callable = object::cast<object::BuiltinFunction>(callee).get();
+        }
+
+        harness::report(std::string("call ") + name, harness::measure([&](std::size_t iterations) {
+            for (std::size_t i {0u}; i < iterations; i++) {
+                harness::keep(callable->call(&interpreter, arguments, paren));
+            }
+        }));
+    }
+
+    const Statements call {compile("identity(1);", &ctx)};
+
+    harness::report("interpret identity(1);", harness::measure([&](std::size_t iterations) {
+        for (std::size_t i {0u}; i < iterations; i++) {
+            interpreter.interpret(call);
+        }
+    }));
+}
+
+// Crossing between the host and the scripts through the embedding API, in both directions
+static bool bench_embedding() {
+    std::ostringstream output;
+    std::istringstream input;
+    embed::Engine engine {&output, &output, &input};
+
+    engine.define_function("host_add", 2u, [](const std::vector<embed::Value>& arguments) -> embed::Value {
+        return std::get<long long>(arguments[0u]) + std::get<long long>(arguments[1u]);
+    });
+
+    engine.define_value("step", 1ll);
+
+    if (!engine.run_source("fun identity(x) { return x; } fun count(n) { for i in range(n) { host_add(i, step); } return n; }")) {
+        std::cerr << "the embedding script failed: " << output.str() << '\n';
+        return false;
+    }
+
+    if (engine.call("count", 10) != embed::Value(10ll) || engine.call("identity", "il") != embed::Value("il")) {
+        std::cerr << "calls through the embedding API returned the wrong values\n";
+        return false;
+    }
+
+    harness::report("embed call identity(1)", harness::measure([&](std::size_t iterations) {
+        for (std::size_t i {0u}; i < iterations; i++) {
+            harness::keep(engine.call("identity", 1));
+        }
+    }));
+
+    harness::report("embed host_add(i, step) from IL", harness::measure([&](std::size_t iterations) {
+        harness::keep(engine.call("count", static_cast<long long>(iterations)));
+    }));
+
+    return true;
+}
+
+// Run a whole script in a fresh interpreter with its own streams, returning what it printed
+static std::string run_isolated(const std::string& source) {
+    std::ostringstream output;
+    std::ostringstream errors;
+    std::istringstream input;
+
+    Context ctx {&errors};
+    Interpreter interpreter {&ctx, &output, &input};
+
+    interpreter.interpret(compile(source, &ctx));
+    interpreter.get_output().flush();
+
+    return output.str() + errors.str();
+}
+
+// Independent interpreters on separate threads must produce the same output as a single one
+static bool bench_concurrency() {
+    const std::string expected {run_isolated(SOURCE_UNIT)};
+    const std::size_t runs {200u};
+
+    std::vector<std::size_t> thread_counts {1u, 2u, 4u};
+    const std::size_t hardware {std::max<std::size_t>(std::thread::hardware_concurrency(), 1u)};
+
+    if (hardware > thread_counts.back()) {
+        thread_counts.push_back(hardware);
+    }
+
+    for (const std::size_t threads : thread_counts) {
+        std::atomic<bool> failed {false};
+        std::vector<std::thread> workers;
+
+        const auto start {std::chrono::steady_clock::now()};
+
+        for (std::size_t i {0u}; i < threads; i++) {
+            workers.emplace_back([&]() {
+                for (std::size_t run {0u}; run < runs; run++) {
+                    if (run_isolated(SOURCE_UNIT) != expected) {
+                        failed = true;
+                    }
+                }
+            });
+        }
+
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+
+        const double seconds {std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()};
+
+        if (failed) {
+            std::cerr << "concurrent interpreters on " << threads << " threads produced different output\n";
+            return false;
+        }
+
+        harness::report(
+            "interpreters on " + std::to_string(threads) + " threads",
+            harness::Measurement {seconds, threads * runs},
+            1.0,
+            "scripts/s"
+        );
+    }
+
+    return true;
+}
+
+// The same compiled program run over and over by one Il per thread, every run with fresh globals
+static bool bench_programs() {
+    const std::string expected {run_isolated(SOURCE_UNIT)};
+    const std::size_t runs {200u};
+
+    std::ostringstream compiler_output;
+    std::istringstream compiler_input;
+    Il compiler {&compiler_output, &compiler_output, &compiler_input};
+
+    const std::shared_ptr<const Program> program {compiler.compile_source(SOURCE_UNIT, "unit")};
+
+    for (const std::size_t threads : {1u, 2u, 4u}) {
+        std::atomic<bool> failed {false};
+        std::vector<std::thread> workers;
+
+        const auto start {std::chrono::steady_clock::now()};
+
+        for (std::size_t i {0u}; i < threads; i++) {
+            workers.emplace_back([&]() {
+                std::ostringstream output;
+                std::istringstream input;
+                Il il {&output, &output, &input};
+
+                for (std::size_t run {0u}; run < runs; run++) {
+                    il.run_program(*program);
+
+                    if (output.str() != expected) {
+                        failed = true;
+                    }
+
+                    output.str({});
+                }
+            });
+        }
+
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+
+        const double seconds {std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()};
+
+        if (failed) {
+            std::cerr << "a shared program on " << threads << " threads produced different output\n";
+            return false;
+        }
+
+        harness::report(
+            "shared program on " + std::to_string(threads) + " threads",
+            harness::Measurement {seconds, threads * runs},
+            1.0,
+            "scripts/s"
+        );
+    }
+
+    return true;
+}
+
+int main() {
+    object::interned::initialize();
+
+    bench_front_end();
+    bench_environment();
+    bench_objects();
+    bench_calls();
+
+    return bench_embedding() && bench_concurrency() && bench_programs() ? 0 : 1;
+}
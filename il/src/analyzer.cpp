@@ -1,5 +1,9 @@
 #include "analyzer.hpp"
 
+#include <string>
+
+#include "builtins.hpp"
+
 void Analyzer::analyze(const std::vector<std::shared_ptr<ast::stmt::Stmt<std::shared_ptr<object::Object>>>>& statements) {
     for (const auto& statement : statements) {
         analyze(statement);
@@ -51,6 +55,18 @@ std::shared_ptr<object::Object> Analyzer::visit(ast::expr::Logical<std::shared_p
 }
 
 std::shared_ptr<object::Object> Analyzer::visit(ast::expr::Call<std::shared_ptr<object::Object>>* expr) {
+    if (memo_function != nullptr) {
+        // Only direct calls can be checked
+        auto variable {std::dynamic_pointer_cast<ast::expr::Variable<std::shared_ptr<object::Object>>>(expr->callee)};
+
+        if (variable != nullptr && builtins::impure(variable->name.get_lexeme())) {
+            ctx->error(
+                variable->name,
+                "Memoized function `" + memo_function->name.get_lexeme() + "` cannot call `" + variable->name.get_lexeme() + "`"
+            );
+        }
+    }
+
     analyze(expr->callee);
 
     for (const auto& argument : expr->arguments) {
@@ -77,6 +93,46 @@ std::shared_ptr<object::Object> Analyzer::visit(ast::expr::Set<std::shared_ptr<o
     return nullptr;
 }
 
+std::shared_ptr<object::Object> Analyzer::visit(ast::expr::Array<std::shared_ptr<object::Object>>* expr) {
+    for (const auto& element : expr->elements) {
+        analyze(element);
+    }
+
+    return nullptr;
+}
+
+std::shared_ptr<object::Object> Analyzer::visit(ast::expr::Index<std::shared_ptr<object::Object>>* expr) {
+    analyze(expr->object);
+    analyze(expr->index);
+
+    return nullptr;
+}
+
+std::shared_ptr<object::Object> Analyzer::visit(ast::expr::IndexSet<std::shared_ptr<object::Object>>* expr) {
+    analyze(expr->object);
+    analyze(expr->index);
+    analyze(expr->value);
+
+    return nullptr;
+}
+
+std::shared_ptr<object::Object> Analyzer::visit(ast::expr::MapLiteral<std::shared_ptr<object::Object>>* expr) {
+    for (std::size_t i {0u}; i < expr->keys.size(); i++) {
+        analyze(expr->keys[i]);
+        analyze(expr->values[i]);
+    }
+
+    return nullptr;
+}
+
+std::shared_ptr<object::Object> Analyzer::visit(ast::expr::SetLiteral<std::shared_ptr<object::Object>>* expr) {
+    for (const auto& element : expr->elements) {
+        analyze(element);
+    }
+
+    return nullptr;
+}
+
 void Analyzer::analyze(std::shared_ptr<ast::stmt::Stmt<std::shared_ptr<object::Object>>> stmt) {
     stmt->accept(this);
 }
@@ -105,10 +161,12 @@ std::shared_ptr<object::Object> Analyzer::visit(const ast::stmt::Function<std::s
     }
 
     inside_function = true;
+    memo_function = stmt->memoized ? stmt : nullptr;
 
     analyze(stmt->body);
 
     inside_function = false;
+    memo_function = nullptr;
 
     return nullptr;
 }
@@ -147,6 +205,22 @@ std::shared_ptr<object::Object> Analyzer::visit(const ast::stmt::While<std::shar
     return nullptr;
 }
 
+std::shared_ptr<object::Object> Analyzer::visit(const ast::stmt::ForRange<std::shared_ptr<object::Object>>* stmt) {
+    if (stmt->start != nullptr) {
+        analyze(stmt->start);
+    }
+
+    analyze(stmt->stop);
+
+    if (stmt->step != nullptr) {
+        analyze(stmt->step);
+    }
+
+    analyze(stmt->body);
+
+    return nullptr;
+}
+
 std::shared_ptr<object::Object> Analyzer::visit(const ast::stmt::Block<std::shared_ptr<object::Object>>* stmt) {
     inside_block = true;
 
@@ -26,6 +26,11 @@ private:
     std::shared_ptr<object::Object> visit(ast::expr::Call<std::shared_ptr<object::Object>>* expr) override;
     std::shared_ptr<object::Object> visit(ast::expr::Get<std::shared_ptr<object::Object>>* expr) override;
     std::shared_ptr<object::Object> visit(ast::expr::Set<std::shared_ptr<object::Object>>* expr) override;
+    std::shared_ptr<object::Object> visit(ast::expr::Array<std::shared_ptr<object::Object>>* expr) override;
+    std::shared_ptr<object::Object> visit(ast::expr::Index<std::shared_ptr<object::Object>>* expr) override;
+    std::shared_ptr<object::Object> visit(ast::expr::IndexSet<std::shared_ptr<object::Object>>* expr) override;
+    std::shared_ptr<object::Object> visit(ast::expr::MapLiteral<std::shared_ptr<object::Object>>* expr) override;
+    std::shared_ptr<object::Object> visit(ast::expr::SetLiteral<std::shared_ptr<object::Object>>* expr) override;
 
     void analyze(std::shared_ptr<ast::stmt::Stmt<std::shared_ptr<object::Object>>> stmt);
 
@@ -35,10 +40,12 @@ private:
     std::shared_ptr<object::Object> visit(const ast::stmt::Struct<std::shared_ptr<object::Object>>* stmt) override;
     std::shared_ptr<object::Object> visit(const ast::stmt::If<std::shared_ptr<object::Object>>* stmt) override;
     std::shared_ptr<object::Object> visit(const ast::stmt::While<std::shared_ptr<object::Object>>* stmt) override;
+    std::shared_ptr<object::Object> visit(const ast::stmt::ForRange<std::shared_ptr<object::Object>>* stmt) override;
     std::shared_ptr<object::Object> visit(const ast::stmt::Block<std::shared_ptr<object::Object>>* stmt) override;
     std::shared_ptr<object::Object> visit(const ast::stmt::Return<std::shared_ptr<object::Object>>* stmt) override;
 
     bool inside_function {false};
+    const ast::stmt::Function<std::shared_ptr<object::Object>>* memo_function {nullptr};  // Set inside a `memo fun`
     bool inside_block {false};
 
     Context* ctx {nullptr};
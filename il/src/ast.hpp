@@ -2,6 +2,7 @@
 
 #include <memory>
 #include <vector>
+#include <cstddef>
 
 #include "token.hpp"
 #include "object.hpp"
@@ -41,6 +42,21 @@ namespace ast {
         template<typename R>
         struct Set;
 
+        template<typename R>
+        struct Array;
+
+        template<typename R>
+        struct Index;
+
+        template<typename R>
+        struct IndexSet;
+
+        template<typename R>
+        struct MapLiteral;
+
+        template<typename R>
+        struct SetLiteral;
+
         template<typename R>
         struct Visitor {
             virtual R visit(Literal<R>* expr) = 0;
@@ -53,6 +69,11 @@ namespace ast {
             virtual R visit(Call<R>* expr) = 0;
             virtual R visit(Get<R>* expr) = 0;
             virtual R visit(Set<R>* expr) = 0;
+            virtual R visit(Array<R>* expr) = 0;
+            virtual R visit(Index<R>* expr) = 0;
+            virtual R visit(IndexSet<R>* expr) = 0;
+            virtual R visit(MapLiteral<R>* expr) = 0;
+            virtual R visit(SetLiteral<R>* expr) = 0;
         };
 
         template<typename R>
@@ -192,6 +213,75 @@ namespace ast {
             token::Token name;
             std::shared_ptr<Expr<R>> value;
         };
+
+        template<typename R>
+        struct Array : Expr<R> {
+            Array(const token::Token& bracket, const std::vector<std::shared_ptr<Expr<R>>>& elements)
+                : bracket(bracket), elements(elements) {}
+
+            R accept(Visitor<R>* visitor) override {
+                return visitor->visit(this);
+            }
+
+            token::Token bracket;
+            std::vector<std::shared_ptr<Expr<R>>> elements;
+        };
+
+        template<typename R>
+        struct Index : Expr<R> {
+            Index(std::shared_ptr<Expr<R>> object, const token::Token& bracket, std::shared_ptr<Expr<R>> index)
+                : object(object), bracket(bracket), index(index) {}
+
+            R accept(Visitor<R>* visitor) override {
+                return visitor->visit(this);
+            }
+
+            std::shared_ptr<Expr<R>> object;
+            token::Token bracket;
+            std::shared_ptr<Expr<R>> index;
+        };
+
+        template<typename R>
+        struct IndexSet : Expr<R> {
+            IndexSet(std::shared_ptr<Expr<R>> object, const token::Token& bracket, std::shared_ptr<Expr<R>> index, std::shared_ptr<Expr<R>> value)
+                : object(object), bracket(bracket), index(index), value(value) {}
+
+            R accept(Visitor<R>* visitor) override {
+                return visitor->visit(this);
+            }
+
+            std::shared_ptr<Expr<R>> object;
+            token::Token bracket;
+            std::shared_ptr<Expr<R>> index;
+            std::shared_ptr<Expr<R>> value;
+        };
+
+        template<typename R>
+        struct MapLiteral : Expr<R> {
+            MapLiteral(const token::Token& brace, const std::vector<std::shared_ptr<Expr<R>>>& keys, const std::vector<std::shared_ptr<Expr<R>>>& values)
+                : brace(brace), keys(keys), values(values) {}
+
+            R accept(Visitor<R>* visitor) override {
+                return visitor->visit(this);
+            }
+
+            token::Token brace;
+            std::vector<std::shared_ptr<Expr<R>>> keys;
+            std::vector<std::shared_ptr<Expr<R>>> values;
+        };
+
+        template<typename R>
+        struct SetLiteral : Expr<R> {
+            SetLiteral(const token::Token& brace, const std::vector<std::shared_ptr<Expr<R>>>& elements)
+                : brace(brace), elements(elements) {}
+
+            R accept(Visitor<R>* visitor) override {
+                return visitor->visit(this);
+            }
+
+            token::Token brace;
+            std::vector<std::shared_ptr<Expr<R>>> elements;
+        };
     }
 
     namespace stmt {
@@ -215,6 +305,9 @@ namespace ast {
         template<typename R>
         struct While;
 
+        template<typename R>
+        struct ForRange;
+
         template<typename R>
         struct Block;
 
@@ -229,6 +322,7 @@ namespace ast {
             virtual R visit(const Struct<R>* stmt) = 0;
             virtual R visit(const If<R>* stmt) = 0;
             virtual R visit(const While<R>* stmt) = 0;
+            virtual R visit(const ForRange<R>* stmt) = 0;
             virtual R visit(const Block<R>* stmt) = 0;
             virtual R visit(const Return<R>* stmt) = 0;
         };
@@ -238,6 +332,8 @@ namespace ast {
             virtual ~Stmt() noexcept = default;
 
             virtual R accept(Visitor<R>* visitor) = 0;
+
+            std::size_t line {};  // Line of the first token; zero for statements synthesized by the parser
         };
 
         template<typename R>
@@ -267,8 +363,8 @@ namespace ast {
 
         template<typename R>
         struct Function : Stmt<R> {
-            Function(const token::Token& name, const std::vector<token::Token>& parameters, const std::vector<std::shared_ptr<Stmt<R>>>& body)
-                : name(name), parameters(parameters), body(body) {}
+            Function(const token::Token& name, const std::vector<token::Token>& parameters, const std::vector<std::shared_ptr<Stmt<R>>>& body, bool memoized = false)
+                : name(name), parameters(parameters), body(body), memoized(memoized) {}
 
             R accept(Visitor<R>* visitor) override {
                 return visitor->visit(this);
@@ -277,6 +373,8 @@ namespace ast {
             token::Token name;
             std::vector<token::Token> parameters;
             std::vector<std::shared_ptr<Stmt<R>>> body;
+            bool memoized {false};  // Declared with `memo fun`
+            std::shared_ptr<lazy::Body> lazy;  // Instead of the body, if it was only pre-parsed
         };
 
         template<typename R>
@@ -326,6 +424,31 @@ namespace ast {
             token::Token paren;
         };
 
+        // Counting loop with a native counter; start and step are null when omitted
+        template<typename R>
+        struct ForRange : Stmt<R> {
+            ForRange(
+                const token::Token& name,
+                const token::Token& range,
+                std::shared_ptr<Expr<R>> start,
+                std::shared_ptr<Expr<R>> stop,
+                std::shared_ptr<Expr<R>> step,
+                std::shared_ptr<Stmt<R>> body
+            )
+                : name(name), range(range), start(start), stop(stop), step(step), body(body) {}
+
+            R accept(Visitor<R>* visitor) override {
+                return visitor->visit(this);
+            }
+
+            token::Token name;
+            token::Token range;
+            std::shared_ptr<Expr<R>> start;
+            std::shared_ptr<Expr<R>> stop;
+            std::shared_ptr<Expr<R>> step;
+            std::shared_ptr<Stmt<R>> body;
+        };
+
         template<typename R>
         struct Block : Stmt<R> {
             Block(const std::vector<std::shared_ptr<Stmt<R>>>& statements)
@@ -341,7 +464,7 @@ namespace ast {
         template<typename R>
         struct Return : Stmt<R> {
             Return(const token::Token& keyword, std::shared_ptr<Expr<R>> value)
-                : keyword(keyword), value(value) {}
+                : keyword(keyword), value(value), tail_call(std::dynamic_pointer_cast<expr::Call<R>>(value)) {}
 
             R accept(Visitor<R>* visitor) override {
                 return visitor->visit(this);
@@ -349,6 +472,7 @@ namespace ast {
 
             token::Token keyword;
             std::shared_ptr<Expr<R>> value;
+            std::shared_ptr<expr::Call<R>> tail_call;  // Set when the value is a call
         };
     }
 }
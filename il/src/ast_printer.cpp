@@ -78,6 +78,44 @@ std::string AstPrinter::visit(ast::expr::Set<std::string>* expr) {
     return parenthesize("set", {expr->name.get_lexeme(), expr->object->accept(this), expr->value->accept(this)});
 }
 
+std::string AstPrinter::visit(ast::expr::Array<std::string>* expr) {
+    std::string elements;
+
+    for (const auto& element : expr->elements) {
+        elements += ' ' + element->accept(this);
+    }
+
+    return "(array" + elements + ")";
+}
+
+std::string AstPrinter::visit(ast::expr::Index<std::string>* expr) {
+    return parenthesize("index", {expr->object, expr->index});
+}
+
+std::string AstPrinter::visit(ast::expr::IndexSet<std::string>* expr) {
+    return parenthesize("index-set", {expr->object, expr->index, expr->value});
+}
+
+std::string AstPrinter::visit(ast::expr::MapLiteral<std::string>* expr) {
+    std::string entries;
+
+    for (std::size_t i {0u}; i < expr->keys.size(); i++) {
+        entries += ' ' + parenthesize("entry", {expr->keys[i], expr->values[i]});
+    }
+
+    return "(map" + entries + ")";
+}
+
+std::string AstPrinter::visit(ast::expr::SetLiteral<std::string>* expr) {
+    std::string elements;
+
+    for (const auto& element : expr->elements) {
+        elements += ' ' + element->accept(this);
+    }
+
+    return "(set-literal" + elements + ")";
+}
+
 std::string AstPrinter::visit([[maybe_unused]] const ast::stmt::Expression<std::string>* stmt) {
     return {};
 }
@@ -102,6 +140,10 @@ std::string AstPrinter::visit([[maybe_unused]] const ast::stmt::While<std::strin
     return {};
 }
 
+std::string AstPrinter::visit([[maybe_unused]] const ast::stmt::ForRange<std::string>* stmt) {
+    return {};
+}
+
 std::string AstPrinter::visit([[maybe_unused]] const ast::stmt::Block<std::string>* stmt) {
     return {};
 }
@@ -23,6 +23,11 @@ private:
     std::string visit(ast::expr::Call<std::string>* expr) override;
     std::string visit(ast::expr::Get<std::string>* expr) override;
     std::string visit(ast::expr::Set<std::string>* expr) override;
+    std::string visit(ast::expr::Array<std::string>* expr) override;
+    std::string visit(ast::expr::Index<std::string>* expr) override;
+    std::string visit(ast::expr::IndexSet<std::string>* expr) override;
+    std::string visit(ast::expr::MapLiteral<std::string>* expr) override;
+    std::string visit(ast::expr::SetLiteral<std::string>* expr) override;
 
     std::string visit(const ast::stmt::Expression<std::string>* stmt) override;
     std::string visit(const ast::stmt::Let<std::string>* stmt) override;
@@ -30,6 +35,7 @@ private:
     std::string visit(const ast::stmt::Struct<std::string>* stmt) override;
     std::string visit(const ast::stmt::If<std::string>* stmt) override;
     std::string visit(const ast::stmt::While<std::string>* stmt) override;
+    std::string visit(const ast::stmt::ForRange<std::string>* stmt) override;
     std::string visit(const ast::stmt::Block<std::string>* stmt) override;
     std::string visit(const ast::stmt::Return<std::string>* stmt) override;
 };
@@ -0,0 +1,226 @@
+#include "batch.hpp"
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <unordered_map>
+#include <cstddef>
+
+#include "il.hpp"
+#include "program.hpp"
+
+namespace batch {
+    struct Result {
+        int status {0};
+        double seconds {};
+        std::string output;
+        std::string errors;
+    };
+
+    struct Compiled {
+        std::shared_ptr<const Program> program;  // Null if it didn't compile
+        std::string errors;
+    };
+
+    static bool read_manifest(const std::string& manifest_path, std::vector<std::string>& file_paths) {
+        std::ifstream stream {manifest_path};
+
+        if (!stream.is_open()) {
+            return false;
+        }
+
+        std::string line;
+
+        // Blank lines and lines starting with # are skipped
+        while (std::getline(stream, line)) {
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+
+            if (!line.empty() && line.front() != '#') {
+                file_paths.push_back(line);
+            }
+        }
+
+        return true;
+    }
+
+    // Runs the body for every index from zero to count on the given number of threads; indices are handed out one at
+    // a time, so that a few long ones don't hold up a whole share of the batch
+    static void parallel(std::size_t count, unsigned int jobs, const std::function<void(std::size_t)>& body) {
+        std::atomic<std::size_t> next {0u};
+
+        const auto work {[&]() {
+            for (std::size_t i {next.fetch_add(1u)}; i < count; i = next.fetch_add(1u)) {
+                body(i);
+            }
+        }};
+
+        std::vector<std::thread> workers;
+        workers.reserve(jobs);
+
+        for (unsigned int i {0u}; i < jobs; i++) {
+            workers.emplace_back(work);
+        }
+
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+    }
+
+    static void compile_one(const std::string& file_path, const std::function<void(Il&)>& configure, Compiled& compiled) {
+        std::ostringstream output;
+        std::ostringstream errors;
+        std::istringstream input;
+
+        Il il {&output, &errors, &input};
+        configure(il);
+
+        compiled.program = il.compile_file(file_path);
+        compiled.errors = errors.str();
+    }
+
+    static void run_one(const Compiled& compiled, const std::function<void(Il&)>& configure, Result& result) {
+        if (compiled.program == nullptr) {
+            result.status = 1;
+            result.errors = compiled.errors;
+            return;
+        }
+
+        std::ostringstream output;
+        std::ostringstream errors;
+        std::istringstream input;  // Scripts in a batch get no input
+
+        const auto start {std::chrono::steady_clock::now()};
+
+        {
+            Il il {&output, &errors, &input};
+            configure(il);
+
+            result.status = il.run_program(*compiled.program);
+        }  // Tearing down the heap counts towards the script's time
+
+        const auto end {std::chrono::steady_clock::now()};
+
+        result.seconds = std::chrono::duration<double>(end - start).count();
+        result.output = output.str();
+        result.errors = errors.str();
+    }
+
+    static void print_captured(const std::string& captured) {
+        std::cout << captured;
+
+        if (!captured.empty() && captured.back() != '\n') {
+            std::cout << '\n';
+        }
+    }
+
+    static void report(
+        const std::vector<std::string>& file_paths,
+        const std::vector<Result>& results,
+        const std::vector<Compiled>& programs,
+        double compile_seconds,
+        unsigned int jobs,
+        double seconds
+    ) {
+        const std::size_t compiled {
+            static_cast<std::size_t>(std::count_if(programs.cbegin(), programs.cend(), [](const Compiled& compiled) {
+                return compiled.program != nullptr;
+            }))
+        };
+
+
+        std::size_t failed {0u};
+
+        std::cout << std::fixed << std::setprecision(3);
+
+        // Scripts are timed from the start of their run; compiling them is a stage of its own, timed in the totals
+        for (std::size_t i {0u}; i < results.size(); i++) {
+            const Result& result {results[i]};
+
+            std::cout << "==> " << file_paths[i] << " (exit " << result.status << ", run " << result.seconds * 1000.0 << " ms)\n";
+            print_captured(result.output);
+
+            if (!result.errors.empty()) {
+                std::cout << "--> stderr\n";
+                print_captured(result.errors);
+            }
+
+            if (result.status != 0) {
+                failed++;
+            }
+        }
+
+        std::cout << "\n" << results.size() << " scripts, " << compiled << " of " << programs.size() << " compiled in "
+            << compile_seconds * 1000.0 << " ms, " << failed << " failed, " << jobs << " jobs, " << seconds * 1000.0 << " ms, " << std::setprecision(1) << static_cast<double>(results.size()) / seconds
+            << " scripts/s\n";
+    }
+
+    int run(const Options& options, const std::vector<std::string>& file_paths, const std::function<void(Il&)>& configure) {
+        std::vector<std::string> all_file_paths {file_paths};
+
+        if (!options.manifest_path.empty() && !read_manifest(options.manifest_path, all_file_paths)) {
+            std::cerr << "il: could not read manifest `" << options.manifest_path << "`\n";
+            return 1;
+        }
+
+        if (all_file_paths.empty()) {
+            return 0;
+        }
+
+        unsigned int jobs {options.jobs > 0u ? options.jobs : std::max(std::thread::hardware_concurrency(), 1u)};
+        jobs = static_cast<unsigned int>(std::min<std::size_t>(jobs, all_file_paths.size()));
+
+        // Every script is compiled once, however many times it's listed
+        std::vector<std::string> distinct_paths;
+        std::unordered_map<std::string, std::size_t> indices;
+        std::vector<std::size_t> program_indices;
+
+        for (const std::string& file_path : all_file_paths) {
+            const auto [iter, inserted] {indices.try_emplace(file_path, distinct_paths.size())};
+
+            if (inserted) {
+                distinct_paths.push_back(file_path);
+            }
+
+            program_indices.push_back(iter->second);
+        }
+
+        std::vector<Compiled> programs (distinct_paths.size());
+        std::vector<Result> results (all_file_paths.size());
+
+        const auto start {std::chrono::steady_clock::now()};
+
+        parallel(distinct_paths.size(), jobs, [&](std::size_t i) {
+            compile_one(distinct_paths[i], configure, programs[i]);
+        });
+
+        const auto compiled {std::chrono::steady_clock::now()};
+
+        parallel(all_file_paths.size(), jobs, [&](std::size_t i) {
+            run_one(programs[program_indices[i]], configure, results[i]);
+        });
+
+        const auto end {std::chrono::steady_clock::now()};
+
+        report(
+            all_file_paths,
+            results,
+            programs,
+            std::chrono::duration<double>(compiled - start).count(),
+            jobs,
+            std::chrono::duration<double>(end - start).count()
+        );
+
+        const bool failed {
+            std::any_of(results.cbegin(), results.cend(), [](const Result& result) { return result.status != 0; })
+        };
+
+        return failed ? 1 : 0;
+    }
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <functional>
+
+class Il;
+
+// Runs many scripts in one process on a pool of threads; every script gets its own interpreter and its output and
+// errors are captured separately, then printed in the order the scripts were given
+namespace batch {
+    struct Options {
+        unsigned int jobs {0u};  // Zero means one per hardware thread
+        std::string manifest_path;  // File with more script paths, one per line
+    };
+
+    int run(const Options& options, const std::vector<std::string>& file_paths, const std::function<void(Il&)>& configure);
+}
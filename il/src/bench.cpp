@@ -0,0 +1,264 @@
+#include "bench.hpp"
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <algorithm>
+#include <numeric>
+#include <new>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+
+#if defined(__unix__) || defined(__APPLE__)
+    #include <sys/resource.h>
+#elif defined(_WIN32)
+    #include <windows.h>
+    #include <psapi.h>
+#endif
+
+#include "il.hpp"
+
+// Counts the dynamic allocations of the thread running the benchmarks, only while it measures; every other thread
+// and every other mode pays one thread-local load per allocation, without sharing anything between threads
+static thread_local bool t_counting {false};
+static thread_local std::size_t t_allocations {0u};
+static thread_local std::size_t t_allocated_bytes {0u};
+
+void* operator new(std::size_t size) {
+    if (t_counting) {
+        t_allocations++;
+        t_allocated_bytes += size;
+    }
+
+    void* pointer {std::malloc(size == 0u ? 1u : size)};
+
+    if (pointer == nullptr) {
+        throw std::bad_alloc();
+    }
+
+    return pointer;
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+namespace bench {
+    struct Result {
+        std::string file_path;
+        bool failed {false};
+        double min {};
+        double median {};
+        double p95 {};
+        double mean {};
+        double stddev {};
+        double allocations {};  // Per run
+        double allocated_bytes {};  // Per run
+        std::size_t peak_rss {};  // Bytes, for the whole process so far
+    };
+
+    static std::size_t peak_rss() {
+#if defined(__unix__) || defined(__APPLE__)
+        rusage usage {};
+        getrusage(RUSAGE_SELF, &usage);
+
+    #if defined(__APPLE__)
+        return static_cast<std::size_t>(usage.ru_maxrss);
+    #else
+        return static_cast<std::size_t>(usage.ru_maxrss) * 1024u;
+    #endif
+#elif defined(_WIN32)
+        PROCESS_MEMORY_COUNTERS counters {};
+        GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+
+        return static_cast<std::size_t>(counters.PeakWorkingSetSize);
+#else
+        return 0u;
+#endif
+    }
+
+    static bool run_once(const std::string& file_path, const std::function<void(Il&)>& configure) {
+        std::ostream null_stream {nullptr};  // Discards everything
+
+        Il il {&null_stream};
+        configure(il);
+
+        return il.run_file(file_path) == 0;
+    }
+
+    static double percentile(const std::vector<double>& sorted, double fraction) {
+        // Nearest-rank method
+        const auto rank {static_cast<std::size_t>(std::ceil(fraction * static_cast<double>(sorted.size())))};
+
+        return sorted[rank == 0u ? 0u : rank - 1u];
+    }
+
+    static Result measure(const Options& options, const std::string& file_path, const std::function<void(Il&)>& configure) {
+        Result result;
+        result.file_path = file_path;
+
+        for (unsigned int i {0u}; i < options.warmup; i++) {
+            if (!run_once(file_path, configure)) {
+                result.failed = true;
+                return result;
+            }
+        }
+
+        std::vector<double> times;
+        times.reserve(options.runs);
+
+        const std::size_t allocations_before {t_allocations};
+        const std::size_t allocated_bytes_before {t_allocated_bytes};
+
+        t_counting = true;
+
+        for (unsigned int i {0u}; i < options.runs; i++) {
+            const auto start {std::chrono::steady_clock::now()};
+
+            if (!run_once(file_path, configure)) {
+                t_counting = false;
+                result.failed = true;
+                return result;
+            }
+
+            const auto end {std::chrono::steady_clock::now()};
+
+            times.push_back(std::chrono::duration<double>(end - start).count());
+        }
+
+        t_counting = false;
+
+        const auto runs {static_cast<double>(options.runs)};
+
+        result.allocations = static_cast<double>(t_allocations - allocations_before) / runs;
+        result.allocated_bytes = static_cast<double>(t_allocated_bytes - allocated_bytes_before) / runs;
+        result.peak_rss = peak_rss();
+
+        std::sort(times.begin(), times.end());
+
+        result.min = times.front();
+        result.median = percentile(times, 0.5);
+        result.p95 = percentile(times, 0.95);
+        result.mean = std::accumulate(times.cbegin(), times.cend(), 0.0) / runs;
+
+        if (times.size() > 1u) {
+            double sum {0.0};
+
+            for (const double time : times) {
+                sum += (time - result.mean) * (time - result.mean);
+            }
+
+            result.stddev = std::sqrt(sum / (runs - 1.0));
+        }
+
+        return result;
+    }
+
+    static std::string escape_json(const std::string& string) {
+        std::string result;
+
+        for (const char character : string) {
+            switch (character) {
+                case '"':
+                    result += "\\\"";
+                    break;
+                case '\\':
+                    result += "\\\\";
+                    break;
+                case '\n':
+                    result += "\\n";
+                    break;
+                case '\t':
+                    result += "\\t";
+                    break;
+                default:
+                    result += character;
+                    break;
+            }
+        }
+
+        return result;
+    }
+
+    static void report_text(const Options& options, const std::vector<Result>& results) {
+        std::cout << "runs: " << options.runs << ", warmup: " << options.warmup << "\n\n";
+
+        std::cout << std::fixed;
+
+        for (const Result& result : results) {
+            std::cout << result.file_path << '\n';
+
+            if (result.failed) {
+                std::cout << "  failed\n\n";
+                continue;
+            }
+
+            std::cout << std::setprecision(3)
+                << "  min      " << std::setw(12) << result.min * 1000.0 << " ms\n"
+                << "  median   " << std::setw(12) << result.median * 1000.0 << " ms\n"
+                << "  p95      " << std::setw(12) << result.p95 * 1000.0 << " ms\n"
+                << "  mean     " << std::setw(12) << result.mean * 1000.0 << " ms\n"
+                << "  stddev   " << std::setw(12) << result.stddev * 1000.0 << " ms\n"
+                << std::setprecision(0)
+                << "  allocs   " << std::setw(12) << result.allocations << " per run\n"
+                << "  bytes    " << std::setw(12) << result.allocated_bytes << " per run\n"
+                << "  peak RSS " << std::setw(12) << static_cast<double>(result.peak_rss) / 1024.0 << " KiB\n\n";
+        }
+    }
+
+    static void report_json(const Options& options, const std::vector<Result>& results) {
+        std::cout << std::setprecision(9);
+
+        std::cout << "{\n  \"runs\": " << options.runs << ",\n  \"warmup\": " << options.warmup << ",\n  \"results\": [";
+
+        for (std::size_t i {0u}; i < results.size(); i++) {
+            const Result& result {results[i]};
+
+            std::cout << (i == 0u ? "\n" : ",\n")
+                << "    {\n"
+                << "      \"file\": \"" << escape_json(result.file_path) << "\",\n"
+                << "      \"failed\": " << (result.failed ? "true" : "false");
+
+            if (!result.failed) {
+                std::cout << ",\n"
+                    << "      \"min_seconds\": " << result.min << ",\n"
+                    << "      \"median_seconds\": " << result.median << ",\n"
+                    << "      \"p95_seconds\": " << result.p95 << ",\n"
+                    << "      \"mean_seconds\": " << result.mean << ",\n"
+                    << "      \"stddev_seconds\": " << result.stddev << ",\n"
+                    << "      \"allocations_per_run\": " << result.allocations << ",\n"
+                    << "      \"allocated_bytes_per_run\": " << result.allocated_bytes << ",\n"
+                    << "      \"peak_rss_bytes\": " << result.peak_rss;
+            }
+
+            std::cout << "\n    }";
+        }
+
+        std::cout << "\n  ]\n}\n";
+    }
+
+    int run(const Options& options, const std::vector<std::string>& file_paths, const std::function<void(Il&)>& configure) {
+        std::vector<Result> results;
+
+        for (const std::string& file_path : file_paths) {
+            results.push_back(measure(options, file_path, configure));
+        }
+
+        if (options.json) {
+            report_json(options, results);
+        } else {
+            report_text(options, results);
+        }
+
+        const bool failed {
+            std::any_of(results.cbegin(), results.cend(), [](const Result& result) { return result.failed; })
+        };
+
+        return failed ? 1 : 0;
+    }
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <functional>
+
+class Il;
+
+// In-process benchmark runner; every run uses a brand new interpreter with its output discarded
+namespace bench {
+    struct Options {
+        unsigned int runs {10u};
+        unsigned int warmup {1u};
+        bool json {false};
+    };
+
+    int run(const Options& options, const std::vector<std::string>& file_paths, const std::function<void(Il&)>& configure);
+}
@@ -1,25 +1,134 @@
 #include "builtins.hpp"
 
 #include <chrono>
-#include <iostream>
+#include <istream>
 #include <string>
 #include <cassert>
-#include <stdexcept>
+#include <algorithm>
+#include <utility>
+#include <unordered_map>
 
 #include "ast.hpp"
+#include "numeric.hpp"
 #include "interpreter.hpp"
 #include "runtime_error.hpp"
+#include "simd.hpp"
+#include "tasks.hpp"
+#include "channels.hpp"
+#include "transfer.hpp"
 
 namespace builtins {
+    static void check_numbers(
+        const std::shared_ptr<object::Object>& array,
+        const token::Token& token,
+        const std::string& name
+    ) {
+        if (array->type != object::Type::IntArray && array->type != object::Type::FloatArray) {
+            throw RuntimeError(token, name + " argument must be an int array or a float array");
+        }
+    }
+
+    static std::size_t check_size(
+        const std::shared_ptr<object::Object>& size,
+        const token::Token& token,
+        const std::string& name
+    ) {
+        const long long value {object::cast<object::Integer>(size)->value};
+
+        if (value < 0ll) {
+            throw RuntimeError(token, name + " size must not be negative");
+        }
+
+        return static_cast<std::size_t>(value);
+    }
+
+    // Both operands of the binary kernels must be numeric arrays of the same type and length
+    static void check_operands(
+        const std::vector<std::shared_ptr<object::Object>>& arguments,
+        const token::Token& token,
+        const std::string& name
+    ) {
+        check_numbers(arguments[0u], token, name);
+
+        if (arguments[1u]->type != arguments[0u]->type) {
+            throw RuntimeError(token, name + " arguments must be arrays of the same type");
+        }
+
+        const std::size_t left {
+            arguments[0u]->type == object::Type::IntArray
+                ? object::cast<object::IntArray>(arguments[0u])->values.size()
+                : object::cast<object::FloatArray>(arguments[0u])->values.size()
+        };
+
+        const std::size_t right {
+            arguments[1u]->type == object::Type::IntArray
+                ? object::cast<object::IntArray>(arguments[1u])->values.size()
+                : object::cast<object::FloatArray>(arguments[1u])->values.size()
+        };
+
+        if (left != right) {
+            throw RuntimeError(token, name + " arguments must have the same length");
+        }
+    }
+
+    static std::shared_ptr<object::Object> elementwise(
+        const std::vector<std::shared_ptr<object::Object>>& arguments,
+        const token::Token& token,
+        const std::string& name,
+        void (*int_kernel)(const long long*, const long long*, long long*, std::size_t),
+        void (*float_kernel)(const double*, const double*, double*, std::size_t)
+    ) {
+        check_operands(arguments, token, name);
+
+        if (arguments[0u]->type == object::Type::IntArray) {
+            const auto& left {object::cast<object::IntArray>(arguments[0u])->values};
+            const auto& right {object::cast<object::IntArray>(arguments[1u])->values};
+
+            std::vector<long long> result(left.size());
+            int_kernel(left.data(), right.data(), result.data(), result.size());
+
+            return object::create_int_array(std::move(result));
+        }
+
+        const auto& left {object::cast<object::FloatArray>(arguments[0u])->values};
+        const auto& right {object::cast<object::FloatArray>(arguments[1u])->values};
+
+        std::vector<double> result(left.size());
+        float_kernel(left.data(), right.data(), result.data(), result.size());
+
+        return object::create_float_array(std::move(result));
+    }
+
+    // The table of either a map or a set; null for anything else
+    static table::Table* as_table(const std::shared_ptr<object::Object>& object) {
+        switch (object->type) {
+            case object::Type::Map:
+                return &object::cast<object::Map>(object)->entries;
+            case object::Type::Set:
+                return &object::cast<object::Set>(object)->elements;
+            default:
+                return nullptr;
+        }
+    }
+
+    static channels::Channel& as_channel(const std::shared_ptr<object::Object>& object, const token::Token& token, const std::string& name) {
+        if (object->type != object::Type::Channel) {
+            throw RuntimeError(token, name + " argument must be a channel");
+        }
+
+        return *object::cast<object::Channel>(object)->channel;
+    }
+
     static long long parse_long_long(const std::string& string, const token::Token& token) {
         long long result {};
 
-        try {
-            result = std::stoll(string);
-        } catch (const std::invalid_argument&) {
-            throw RuntimeError(token, "Invalid integer value");
-        } catch (const std::out_of_range&) {
-            throw RuntimeError(token, "Integer value out of range");
+        switch (numeric::parse(string, result)) {
+            case numeric::Error::None:
+                break;
+            case numeric::Error::Invalid:
+                throw RuntimeError(token, "Invalid integer value");
+            case numeric::Error::OutOfRange:
+                throw RuntimeError(token, "Integer value out of range");
         }
 
         return result;
@@ -28,12 +137,13 @@ namespace builtins {
     static double parse_double(const std::string& string, const token::Token& token) {
         double result {};
 
-        try {
-            result = std::stod(string);
-        } catch (const std::invalid_argument&) {
-            throw RuntimeError(token, "Invalid float value");
-        } catch (const std::out_of_range&) {
-            throw RuntimeError(token, "Float value out of range");
+        switch (numeric::parse(string, result)) {
+            case numeric::Error::None:
+                break;
+            case numeric::Error::Invalid:
+                throw RuntimeError(token, "Invalid float value");
+            case numeric::Error::OutOfRange:
+                throw RuntimeError(token, "Float value out of range");
         }
 
         return result;
@@ -54,11 +164,11 @@ namespace builtins {
     }
 
     std::shared_ptr<object::Object> print::call(
-        Interpreter*,
+        Interpreter* interpreter,
         const std::vector<std::shared_ptr<object::Object>>& arguments,
         const token::Token&
     ) {
-        std::cout << arguments[0u]->to_string();
+        arguments[0u]->write(interpreter->get_output());
 
         return object::create_none();
     }
@@ -68,11 +178,14 @@ namespace builtins {
     }
 
     std::shared_ptr<object::Object> println::call(
-        Interpreter*,
+        Interpreter* interpreter,
         const std::vector<std::shared_ptr<object::Object>>& arguments,
         const token::Token&
     ) {
-        std::cout << arguments[0u]->to_string() << std::endl;
+        Output& output {interpreter->get_output()};
+
+        arguments[0u]->write(output);
+        output.write('\n');
 
         return object::create_none();
     }
@@ -82,22 +195,28 @@ namespace builtins {
     }
 
     std::shared_ptr<object::Object> input::call(
-        Interpreter*,
+        Interpreter* interpreter,
         const std::vector<std::shared_ptr<object::Object>>& arguments,
         const token::Token&
     ) {
-        std::cout << arguments[0u]->to_string();
+        Output& output {interpreter->get_output()};
+
+        // The prompt and everything before it must be visible before blocking
+        arguments[0u]->write(output);
+        output.flush();
+
+        std::istream& stream {interpreter->get_input()};
 
         std::string buffer;
-        std::getline(std::cin, buffer);
+        std::getline(stream, buffer);
 
-        if (std::cin.eof()) {
-            std::cin.clear();
+        if (stream.eof()) {
+            stream.clear();
             return object::create_string("");
         }
 
-        if (std::cin.bad()) {
-            std::cin.clear();
+        if (stream.bad()) {
+            stream.clear();
             return object::create_string("");
         }
 
@@ -108,6 +227,40 @@ namespace builtins {
         return 1u;
     }
 
+    std::shared_ptr<object::Object> flush::call(
+        Interpreter* interpreter,
+        const std::vector<std::shared_ptr<object::Object>>&,
+        const token::Token&
+    ) {
+        interpreter->get_output().flush();
+
+        return object::create_none();
+    }
+
+    std::size_t flush::arity() const {
+        return 0u;
+    }
+
+    // A new array every time, so that scripts can modify it
+    std::shared_ptr<object::Object> args::call(
+        Interpreter* interpreter,
+        const std::vector<std::shared_ptr<object::Object>>&,
+        const token::Token&
+    ) {
+        std::vector<std::shared_ptr<object::Object>> elements;
+        elements.reserve(interpreter->get_arguments().size());
+
+        for (const std::string& argument : interpreter->get_arguments()) {
+            elements.push_back(object::create_string(argument));
+        }
+
+        return object::create_array(std::move(elements));
+    }
+
+    std::size_t args::arity() const {
+        return 0u;
+    }
+
     std::shared_ptr<object::Object> str::call(
         Interpreter*,
         const std::vector<std::shared_ptr<object::Object>>& arguments,
@@ -229,4 +382,772 @@ namespace builtins {
     std::size_t bool_::arity() const {
         return 1u;
     }
+
+    std::shared_ptr<object::Object> len::call(
+        Interpreter*,
+        const std::vector<std::shared_ptr<object::Object>>& arguments,
+        const token::Token& token
+    ) {
+        auto argument {arguments[0u]};
+
+        switch (argument->type) {
+            case object::Type::String:
+                return object::create_integer(
+                    static_cast<long long>(object::cast<object::String>(argument)->value.size())
+                );
+            case object::Type::Array:
+                return object::create_integer(
+                    static_cast<long long>(object::cast<object::Array>(argument)->elements.size())
+                );
+            case object::Type::Map:
+                return object::create_integer(
+                    static_cast<long long>(object::cast<object::Map>(argument)->entries.size())
+                );
+            case object::Type::Set:
+                return object::create_integer(
+                    static_cast<long long>(object::cast<object::Set>(argument)->elements.size())
+                );
+            case object::Type::IntArray:
+                return object::create_integer(
+                    static_cast<long long>(object::cast<object::IntArray>(argument)->values.size())
+                );
+            case object::Type::FloatArray:
+                return object::create_integer(
+                    static_cast<long long>(object::cast<object::FloatArray>(argument)->values.size())
+                );
+            default:
+                throw RuntimeError(token, "len() argument must be a string, array, map or set");
+        }
+
+        assert(false);
+        return nullptr;
+    }
+
+    std::size_t len::arity() const {
+        return 1u;
+    }
+
+    std::shared_ptr<object::Object> push::call(
+        Interpreter*,
+        const std::vector<std::shared_ptr<object::Object>>& arguments,
+        const token::Token& token
+    ) {
+        if (arguments[0u]->type != object::Type::Array) {
+            throw RuntimeError(token, "push() first argument must be an array");
+        }
+
+        object::cast<object::Array>(arguments[0u])->elements.push_back(arguments[1u]);
+
+        return object::create_none();
+    }
+
+    std::size_t push::arity() const {
+        return 2u;
+    }
+
+    std::shared_ptr<object::Object> pop::call(
+        Interpreter*,
+        const std::vector<std::shared_ptr<object::Object>>& arguments,
+        const token::Token& token
+    ) {
+        if (arguments[0u]->type != object::Type::Array) {
+            throw RuntimeError(token, "pop() argument must be an array");
+        }
+
+        auto array {object::cast<object::Array>(arguments[0u])};
+
+        if (array->elements.empty()) {
+            throw RuntimeError(token, "pop() from an empty array");
+        }
+
+        std::shared_ptr<object::Object> result {std::move(array->elements.back())};
+        array->elements.pop_back();
+
+        return result;
+    }
+
+    std::size_t pop::arity() const {
+        return 1u;
+    }
+
+    std::shared_ptr<object::Object> slice::call(
+        Interpreter*,
+        const std::vector<std::shared_ptr<object::Object>>& arguments,
+        const token::Token& token
+    ) {
+        if (arguments[0u]->type != object::Type::Array) {
+            throw RuntimeError(token, "slice() first argument must be an array");
+        }
+
+        if (arguments[1u]->type != object::Type::Integer || arguments[2u]->type != object::Type::Integer) {
+            throw RuntimeError(token, "slice() bounds must be integers");
+        }
+
+        const auto& elements {object::cast<object::Array>(arguments[0u])->elements};
+        const auto size {static_cast<long long>(elements.size())};
+
+        // Out of range bounds are clamped, like in Python
+        const long long start {std::clamp(object::cast<object::Integer>(arguments[1u])->value, 0ll, size)};
+        const long long stop {std::clamp(object::cast<object::Integer>(arguments[2u])->value, start, size)};
+
+        return object::create_array(std::vector<std::shared_ptr<object::Object>>(elements.cbegin() + start, elements.cbegin() + stop));
+    }
+
+    std::size_t slice::arity() const {
+        return 3u;
+    }
+
+    std::shared_ptr<object::Object> get::call(
+        Interpreter*,
+        const std::vector<std::shared_ptr<object::Object>>& arguments,
+        const token::Token& token
+    ) {
+        if (arguments[0u]->type != object::Type::Map) {
+            throw RuntimeError(token, "get() first argument must be a map");
+        }
+
+        const std::size_t hash {Interpreter::hash_key(token, arguments[1u])};
+        std::shared_ptr<object::Object>* value {object::cast<object::Map>(arguments[0u])->entries.find(*arguments[1u], hash)};
+
+        return value != nullptr ? *value : object::create_none();
+    }
+
+    std::size_t get::arity() const {
+        return 2u;
+    }
+
+    std::shared_ptr<object::Object> set_::call(
+        Interpreter*,
+        const std::vector<std::shared_ptr<object::Object>>& arguments,
+        const token::Token& token
+    ) {
+        if (arguments[0u]->type != object::Type::Map) {
+            throw RuntimeError(token, "set() first argument must be a map");
+        }
+
+        const std::size_t hash {Interpreter::hash_key(token, arguments[1u])};
+        object::cast<object::Map>(arguments[0u])->entries.insert(arguments[1u], hash, arguments[2u]);
+
+        return object::create_none();
+    }
+
+    std::size_t set_::arity() const {
+        return 3u;
+    }
+
+    std::shared_ptr<object::Object> has::call(
+        Interpreter*,
+        const std::vector<std::shared_ptr<object::Object>>& arguments,
+        const token::Token& token
+    ) {
+        table::Table* table {as_table(arguments[0u])};
+
+        if (table == nullptr) {
+            throw RuntimeError(token, "has() first argument must be a map or a set");
+        }
+
+        const std::size_t hash {Interpreter::hash_key(token, arguments[1u])};
+
+        return object::create_bool(table->find(*arguments[1u], hash) != nullptr);
+    }
+
+    std::size_t has::arity() const {
+        return 2u;
+    }
+
+    std::shared_ptr<object::Object> remove::call(
+        Interpreter*,
+        const std::vector<std::shared_ptr<object::Object>>& arguments,
+        const token::Token& token
+    ) {
+        table::Table* table {as_table(arguments[0u])};
+
+        if (table == nullptr) {
+            throw RuntimeError(token, "remove() first argument must be a map or a set");
+        }
+
+        const std::size_t hash {Interpreter::hash_key(token, arguments[1u])};
+
+        return object::create_bool(table->remove(*arguments[1u], hash));
+    }
+
+    std::size_t remove::arity() const {
+        return 2u;
+    }
+
+    std::shared_ptr<object::Object> add::call(
+        Interpreter*,
+        const std::vector<std::shared_ptr<object::Object>>& arguments,
+        const token::Token& token
+    ) {
+        if (arguments[0u]->type == object::Type::IntArray || arguments[0u]->type == object::Type::FloatArray) {
+            return elementwise(arguments, token, "add()", simd::add, simd::add);
+        }
+
+        if (arguments[0u]->type != object::Type::Set) {
+            throw RuntimeError(token, "add() first argument must be a set, an int array or a float array");
+        }
+
+        const std::size_t hash {Interpreter::hash_key(token, arguments[1u])};
+
+        return object::create_bool(object::cast<object::Set>(arguments[0u])->elements.insert(arguments[1u], hash, nullptr));
+    }
+
+    std::size_t add::arity() const {
+        return 2u;
+    }
+
+    std::shared_ptr<object::Object> keys::call(
+        Interpreter*,
+        const std::vector<std::shared_ptr<object::Object>>& arguments,
+        const token::Token& token
+    ) {
+        table::Table* table {as_table(arguments[0u])};
+
+        if (table == nullptr) {
+            throw RuntimeError(token, "keys() argument must be a map or a set");
+        }
+
+        std::vector<std::shared_ptr<object::Object>> result;
+        result.reserve(table->size());
+
+        table->for_each([&](const std::shared_ptr<object::Object>& key, const std::shared_ptr<object::Object>&) {
+            result.push_back(key);
+        });
+
+        return object::create_array(std::move(result));
+    }
+
+    std::size_t keys::arity() const {
+        return 1u;
+    }
+
+    std::shared_ptr<object::Object> values::call(
+        Interpreter*,
+        const std::vector<std::shared_ptr<object::Object>>& arguments,
+        const token::Token& token
+    ) {
+        if (arguments[0u]->type != object::Type::Map) {
+            throw RuntimeError(token, "values() argument must be a map");
+        }
+
+        const table::Table& entries {object::cast<object::Map>(arguments[0u])->entries};
+
+        std::vector<std::shared_ptr<object::Object>> result;
+        result.reserve(entries.size());
+
+        entries.for_each([&](const std::shared_ptr<object::Object>&, const std::shared_ptr<object::Object>& value) {
+            result.push_back(value);
+        });
+
+        return object::create_array(std::move(result));
+    }
+
+    std::size_t values::arity() const {
+        return 1u;
+    }
+
+    std::shared_ptr<object::Object> empty_set::call(
+        Interpreter*,
+        const std::vector<std::shared_ptr<object::Object>>&,
+        const token::Token&
+    ) {
+        return object::create_set();
+    }
+
+    std::size_t empty_set::arity() const {
+        return 0u;
+    }
+
+    std::shared_ptr<object::Object> int_array::call(
+        Interpreter*,
+        const std::vector<std::shared_ptr<object::Object>>& arguments,
+        const token::Token& token
+    ) {
+        const auto& argument {arguments[0u]};
+
+        if (argument->type == object::Type::Integer) {
+            return object::create_int_array(std::vector<long long>(check_size(argument, token, "int_array()")));
+        }
+
+        if (argument->type != object::Type::Array) {
+            throw RuntimeError(token, "int_array() argument must be a size or an array");
+        }
+
+        const auto& elements {object::cast<object::Array>(argument)->elements};
+
+        std::vector<long long> values;
+        values.reserve(elements.size());
+
+        for (const auto& element : elements) {
+            if (element->type != object::Type::Integer) {
+                throw RuntimeError(token, "Elements of int arrays must be integers");
+            }
+
+            values.push_back(object::cast<object::Integer>(element)->value);
+        }
+
+        return object::create_int_array(std::move(values));
+    }
+
+    std::size_t int_array::arity() const {
+        return 1u;
+    }
+
+    std::shared_ptr<object::Object> float_array::call(
+        Interpreter*,
+        const std::vector<std::shared_ptr<object::Object>>& arguments,
+        const token::Token& token
+    ) {
+        const auto& argument {arguments[0u]};
+
+        switch (argument->type) {
+            case object::Type::Integer:
+                return object::create_float_array(std::vector<double>(check_size(argument, token, "float_array()")));
+            case object::Type::IntArray: {
+                const auto& values {object::cast<object::IntArray>(argument)->values};
+
+                return object::create_float_array(std::vector<double>(values.cbegin(), values.cend()));
+            }
+            case object::Type::Array: {
+                const auto& elements {object::cast<object::Array>(argument)->elements};
+
+                std::vector<double> values;
+                values.reserve(elements.size());
+
+                for (const auto& element : elements) {
+                    double value {};
+
+                    if (!Interpreter::numeric_value(element, value)) {
+                        throw RuntimeError(token, "Elements of float arrays must be numbers");
+                    }
+
+                    values.push_back(value);
+                }
+
+                return object::create_float_array(std::move(values));
+            }
+            default:
+                throw RuntimeError(token, "float_array() argument must be a size, an array or an int array");
+        }
+    }
+
+    std::size_t float_array::arity() const {
+        return 1u;
+    }
+
+    std::shared_ptr<object::Object> sum::call(
+        Interpreter*,
+        const std::vector<std::shared_ptr<object::Object>>& arguments,
+        const token::Token& token
+    ) {
+        check_numbers(arguments[0u], token, "sum()");
+
+        if (arguments[0u]->type == object::Type::IntArray) {
+            const auto& values {object::cast<object::IntArray>(arguments[0u])->values};
+
+            return object::create_integer(simd::sum(values.data(), values.size()));
+        }
+
+        const auto& values {object::cast<object::FloatArray>(arguments[0u])->values};
+
+        return object::create_float(simd::sum(values.data(), values.size()));
+    }
+
+    std::size_t sum::arity() const {
+        return 1u;
+    }
+
+    std::shared_ptr<object::Object> min::call(
+        Interpreter*,
+        const std::vector<std::shared_ptr<object::Object>>& arguments,
+        const token::Token& token
+    ) {
+        check_numbers(arguments[0u], token, "min()");
+
+        if (arguments[0u]->type == object::Type::IntArray) {
+            const auto& values {object::cast<object::IntArray>(arguments[0u])->values};
+
+            if (values.empty()) {
+                throw RuntimeError(token, "min() of an empty array");
+            }
+
+            return object::create_integer(simd::min(values.data(), values.size()));
+        }
+
+        const auto& values {object::cast<object::FloatArray>(arguments[0u])->values};
+
+        if (values.empty()) {
+            throw RuntimeError(token, "min() of an empty array");
+        }
+
+        return object::create_float(simd::min(values.data(), values.size()));
+    }
+
+    std::size_t min::arity() const {
+        return 1u;
+    }
+
+    std::shared_ptr<object::Object> max::call(
+        Interpreter*,
+        const std::vector<std::shared_ptr<object::Object>>& arguments,
+        const token::Token& token
+    ) {
+        check_numbers(arguments[0u], token, "max()");
+
+        if (arguments[0u]->type == object::Type::IntArray) {
+            const auto& values {object::cast<object::IntArray>(arguments[0u])->values};
+
+            if (values.empty()) {
+                throw RuntimeError(token, "max() of an empty array");
+            }
+
+            return object::create_integer(simd::max(values.data(), values.size()));
+        }
+
+        const auto& values {object::cast<object::FloatArray>(arguments[0u])->values};
+
+        if (values.empty()) {
+            throw RuntimeError(token, "max() of an empty array");
+        }
+
+        return object::create_float(simd::max(values.data(), values.size()));
+    }
+
+    std::size_t max::arity() const {
+        return 1u;
+    }
+
+    std::shared_ptr<object::Object> dot::call(
+        Interpreter*,
+        const std::vector<std::shared_ptr<object::Object>>& arguments,
+        const token::Token& token
+    ) {
+        check_operands(arguments, token, "dot()");
+
+        if (arguments[0u]->type == object::Type::IntArray) {
+            const auto& left {object::cast<object::IntArray>(arguments[0u])->values};
+            const auto& right {object::cast<object::IntArray>(arguments[1u])->values};
+
+            return object::create_integer(simd::dot(left.data(), right.data(), left.size()));
+        }
+
+        const auto& left {object::cast<object::FloatArray>(arguments[0u])->values};
+        const auto& right {object::cast<object::FloatArray>(arguments[1u])->values};
+
+        return object::create_float(simd::dot(left.data(), right.data(), left.size()));
+    }
+
+    std::size_t dot::arity() const {
+        return 2u;
+    }
+
+    std::shared_ptr<object::Object> mul::call(
+        Interpreter*,
+        const std::vector<std::shared_ptr<object::Object>>& arguments,
+        const token::Token& token
+    ) {
+        return elementwise(arguments, token, "mul()", simd::mul, simd::mul);
+    }
+
+    std::size_t mul::arity() const {
+        return 2u;
+    }
+
+    std::shared_ptr<object::Object> scale::call(
+        Interpreter*,
+        const std::vector<std::shared_ptr<object::Object>>& arguments,
+        const token::Token& token
+    ) {
+        check_numbers(arguments[0u], token, "scale()");
+
+        if (arguments[0u]->type == object::Type::IntArray) {
+            if (arguments[1u]->type != object::Type::Integer) {
+                throw RuntimeError(token, "scale() factor of an int array must be an integer");
+            }
+
+            const auto& values {object::cast<object::IntArray>(arguments[0u])->values};
+
+            std::vector<long long> result(values.size());
+            simd::scale(values.data(), object::cast<object::Integer>(arguments[1u])->value, result.data(), result.size());
+
+            return object::create_int_array(std::move(result));
+        }
+
+        double factor {};
+
+        if (!Interpreter::numeric_value(arguments[1u], factor)) {
+            throw RuntimeError(token, "scale() factor must be a number");
+        }
+
+        const auto& values {object::cast<object::FloatArray>(arguments[0u])->values};
+
+        std::vector<double> result(values.size());
+        simd::scale(values.data(), factor, result.data(), result.size());
+
+        return object::create_float_array(std::move(result));
+    }
+
+    std::size_t scale::arity() const {
+        return 2u;
+    }
+
+    std::shared_ptr<object::Object> prefix_sum::call(
+        Interpreter*,
+        const std::vector<std::shared_ptr<object::Object>>& arguments,
+        const token::Token& token
+    ) {
+        check_numbers(arguments[0u], token, "prefix_sum()");
+
+        if (arguments[0u]->type == object::Type::IntArray) {
+            const auto& values {object::cast<object::IntArray>(arguments[0u])->values};
+
+            std::vector<long long> result(values.size());
+            simd::prefix_sum(values.data(), result.data(), result.size());
+
+            return object::create_int_array(std::move(result));
+        }
+
+        const auto& values {object::cast<object::FloatArray>(arguments[0u])->values};
+
+        std::vector<double> result(values.size());
+        simd::prefix_sum(values.data(), result.data(), result.size());
+
+        return object::create_float_array(std::move(result));
+    }
+
+    std::size_t prefix_sum::arity() const {
+        return 1u;
+    }
+
+    std::shared_ptr<object::Object> fill::call(
+        Interpreter*,
+        const std::vector<std::shared_ptr<object::Object>>& arguments,
+        const token::Token& token
+    ) {
+        check_numbers(arguments[0u], token, "fill()");
+
+        if (arguments[0u]->type == object::Type::IntArray) {
+            if (arguments[1u]->type != object::Type::Integer) {
+                throw RuntimeError(token, "Elements of int arrays must be integers");
+            }
+
+            auto& values {object::cast<object::IntArray>(arguments[0u])->values};
+            simd::fill(values.data(), object::cast<object::Integer>(arguments[1u])->value, values.size());
+
+            return object::create_none();
+        }
+
+        double value {};
+
+        if (!Interpreter::numeric_value(arguments[1u], value)) {
+            throw RuntimeError(token, "Elements of float arrays must be numbers");
+        }
+
+        auto& values {object::cast<object::FloatArray>(arguments[0u])->values};
+        simd::fill(values.data(), value, values.size());
+
+        return object::create_none();
+    }
+
+    std::size_t fill::arity() const {
+        return 2u;
+    }
+
+    std::shared_ptr<object::Object> spawn::call(
+        Interpreter* interpreter,
+        const std::vector<std::shared_ptr<object::Object>>& arguments,
+        const token::Token& token
+    ) {
+        const std::shared_ptr<object::Object>& callee {arguments[0u]};
+
+        if (object::as_callable(callee) == nullptr) {
+            throw RuntimeError(token, "spawn() first argument must be callable");
+        }
+
+        const std::vector<std::shared_ptr<object::Object>> call_arguments (arguments.cbegin() + 1, arguments.cend());
+
+        // Fail here rather than on another thread
+        Interpreter::check_arity(
+            token,
+            callee,
+            callee->type == object::Type::Method ? call_arguments.size() + 1u : call_arguments.size()
+        );
+
+        auto task {std::make_shared<tasks::Task>(*interpreter, callee, call_arguments, token)};
+        tasks::submit(task);
+
+        return object::create_task(std::move(task));
+    }
+
+    std::size_t spawn::arity() const {
+        return 1u;
+    }
+
+    bool spawn::variadic() const {
+        return true;
+    }
+
+    std::shared_ptr<object::Object> join::call(
+        Interpreter* interpreter,
+        const std::vector<std::shared_ptr<object::Object>>& arguments,
+        const token::Token& token
+    ) {
+        if (arguments[0u]->type != object::Type::Task) {
+            throw RuntimeError(token, "join() argument must be a task");
+        }
+
+        return object::cast<object::Task>(arguments[0u])->task->join(*interpreter, token);
+    }
+
+    std::size_t join::arity() const {
+        return 1u;
+    }
+
+    std::shared_ptr<object::Object> channel::call(
+        Interpreter*,
+        const std::vector<std::shared_ptr<object::Object>>& arguments,
+        const token::Token& token
+    ) {
+        if (arguments[0u]->type != object::Type::Integer || object::cast<object::Integer>(arguments[0u])->value < 1ll) {
+            throw RuntimeError(token, "channel() capacity must be a positive integer");
+        }
+
+        const auto capacity {static_cast<std::size_t>(object::cast<object::Integer>(arguments[0u])->value)};
+
+        return object::create_channel(std::make_shared<channels::Channel>(capacity));
+    }
+
+    std::size_t channel::arity() const {
+        return 1u;
+    }
+
+    std::shared_ptr<object::Object> send::call(
+        Interpreter* interpreter,
+        const std::vector<std::shared_ptr<object::Object>>& arguments,
+        const token::Token& token
+    ) {
+        channels::Channel& channel {as_channel(arguments[0u], token, "send()")};
+
+        // The receiver gets a copy nothing else refers to; immutable values, like strings, are passed as they are
+        switch (channel.send(transfer::Copier(*interpreter, token).copy(arguments[1u]))) {
+            case channels::Status::Done:
+                break;
+            case channels::Status::Closed:
+                throw RuntimeError(token, "Cannot send to a closed channel");
+            case channels::Status::Interrupted:
+                throw RuntimeError(token, "Interrupted while sending");
+        }
+
+        return object::create_none();
+    }
+
+    std::size_t send::arity() const {
+        return 2u;
+    }
+
+    std::shared_ptr<object::Object> recv::call(
+        Interpreter*,
+        const std::vector<std::shared_ptr<object::Object>>& arguments,
+        const token::Token& token
+    ) {
+        channels::Channel& channel {as_channel(arguments[0u], token, "recv()")};
+        std::shared_ptr<object::Object> value;
+
+        switch (channel.receive(value)) {
+            case channels::Status::Done:
+                break;
+            case channels::Status::Closed:
+                return object::create_none();
+            case channels::Status::Interrupted:
+                throw RuntimeError(token, "Interrupted while receiving");
+        }
+
+        return value;
+    }
+
+    std::size_t recv::arity() const {
+        return 1u;
+    }
+
+    std::shared_ptr<object::Object> close::call(
+        Interpreter*,
+        const std::vector<std::shared_ptr<object::Object>>& arguments,
+        const token::Token& token
+    ) {
+        as_channel(arguments[0u], token, "close()").close();
+
+        return object::create_none();
+    }
+
+    std::size_t close::arity() const {
+        return 1u;
+    }
+
+    template<typename T>
+    static void create(std::vector<std::pair<std::string, std::shared_ptr<object::Object>>>& builtins, const char* name) {
+        builtins.emplace_back(name, object::create_builtin_function<T>(name));
+    }
+
+    std::vector<std::pair<std::string, std::shared_ptr<object::Object>>> create_all() {
+        std::vector<std::pair<std::string, std::shared_ptr<object::Object>>> builtins;
+
+        create<clock>(builtins, "clock");
+        create<print>(builtins, "print");
+        create<println>(builtins, "println");
+        create<input>(builtins, "input");
+        create<flush>(builtins, "flush");
+        create<args>(builtins, "args");
+        create<str>(builtins, "str");
+        create<int_>(builtins, "int");
+        create<float_>(builtins, "float");
+        create<bool_>(builtins, "bool");
+        create<len>(builtins, "len");
+        create<push>(builtins, "push");
+        create<pop>(builtins, "pop");
+        create<slice>(builtins, "slice");
+        create<get>(builtins, "get");
+        create<set_>(builtins, "set");
+        create<has>(builtins, "has");
+        create<remove>(builtins, "remove");
+        create<add>(builtins, "add");
+        create<keys>(builtins, "keys");
+        create<values>(builtins, "values");
+        create<empty_set>(builtins, "empty_set");
+        create<int_array>(builtins, "int_array");
+        create<float_array>(builtins, "float_array");
+        create<sum>(builtins, "sum");
+        create<min>(builtins, "min");
+        create<max>(builtins, "max");
+        create<dot>(builtins, "dot");
+        create<mul>(builtins, "mul");
+        create<scale>(builtins, "scale");
+        create<prefix_sum>(builtins, "prefix_sum");
+        create<fill>(builtins, "fill");
+        create<spawn>(builtins, "spawn");
+        create<join>(builtins, "join");
+        create<channel>(builtins, "channel");
+        create<send>(builtins, "send");
+        create<recv>(builtins, "recv");
+        create<close>(builtins, "close");
+
+        return builtins;
+    }
+
+    bool impure(const std::string& name) {
+        // Every builtin declares whether it's pure, so the names are taken from the builtins themselves
+        static const std::unordered_map<std::string, bool> pure {[]() {
+            std::unordered_map<std::string, bool> pure;
+
+            for (const auto& [name, builtin] : create_all()) {
+                pure[name] = object::cast<object::BuiltinFunction>(builtin)->pure;
+            }
+
+            return pure;
+        }()};
+
+        const auto iter {pure.find(name)};
+
+        return iter != pure.cend() && !iter->second;
+    }
 }
@@ -1,9 +1,16 @@
 #pragma once
 
+#include <string>
+#include <vector>
+#include <utility>
+#include <memory>
+
 #include "object.hpp"
 
 namespace builtins {
     struct clock : object::BuiltinFunction {
+        static constexpr bool PURE {false};
+
         std::shared_ptr<object::Object> call(
             Interpreter*,
             const std::vector<std::shared_ptr<object::Object>>&,
@@ -14,8 +21,10 @@ namespace builtins {
     };
 
     struct print : object::BuiltinFunction {
+        static constexpr bool PURE {false};
+
         std::shared_ptr<object::Object> call(
-            Interpreter*,
+            Interpreter* interpreter,
             const std::vector<std::shared_ptr<object::Object>>& arguments,
             const token::Token&
         ) override;
@@ -24,8 +33,10 @@ namespace builtins {
     };
 
     struct println : object::BuiltinFunction {
+        static constexpr bool PURE {false};
+
         std::shared_ptr<object::Object> call(
-            Interpreter*,
+            Interpreter* interpreter,
             const std::vector<std::shared_ptr<object::Object>>& arguments,
             const token::Token&
         ) override;
@@ -34,8 +45,10 @@ namespace builtins {
     };
 
     struct input : object::BuiltinFunction {
+        static constexpr bool PURE {false};
+
         std::shared_ptr<object::Object> call(
-            Interpreter*,
+            Interpreter* interpreter,
             const std::vector<std::shared_ptr<object::Object>>& arguments,
             const token::Token&
         ) override;
@@ -43,7 +56,33 @@ namespace builtins {
         std::size_t arity() const override;
     };
 
+    struct flush : object::BuiltinFunction {
+        static constexpr bool PURE {false};
+
+        std::shared_ptr<object::Object> call(
+            Interpreter* interpreter,
+            const std::vector<std::shared_ptr<object::Object>>&,
+            const token::Token&
+        ) override;
+
+        std::size_t arity() const override;
+    };
+
+    struct args : object::BuiltinFunction {
+        static constexpr bool PURE {false};
+
+        std::shared_ptr<object::Object> call(
+            Interpreter* interpreter,
+            const std::vector<std::shared_ptr<object::Object>>&,
+            const token::Token&
+        ) override;
+
+        std::size_t arity() const override;
+    };
+
     struct str : object::BuiltinFunction {
+        static constexpr bool PURE {true};
+
         std::shared_ptr<object::Object> call(
             Interpreter*,
             const std::vector<std::shared_ptr<object::Object>>& arguments,
@@ -54,6 +93,8 @@ namespace builtins {
     };
 
     struct int_ : object::BuiltinFunction {
+        static constexpr bool PURE {true};
+
         std::shared_ptr<object::Object> call(
             Interpreter*,
             const std::vector<std::shared_ptr<object::Object>>& arguments,
@@ -63,6 +104,8 @@ namespace builtins {
     };
 
     struct float_ : object::BuiltinFunction {
+        static constexpr bool PURE {true};
+
         std::shared_ptr<object::Object> call(
             Interpreter*,
             const std::vector<std::shared_ptr<object::Object>>& arguments,
@@ -73,6 +116,32 @@ namespace builtins {
     };
 
     struct bool_ : object::BuiltinFunction {
+        static constexpr bool PURE {true};
+
+        std::shared_ptr<object::Object> call(
+            Interpreter*,
+            const std::vector<std::shared_ptr<object::Object>>& arguments,
+            const token::Token& token
+        ) override;
+
+        std::size_t arity() const override;
+    };
+
+    struct len : object::BuiltinFunction {
+        static constexpr bool PURE {true};
+
+        std::shared_ptr<object::Object> call(
+            Interpreter*,
+            const std::vector<std::shared_ptr<object::Object>>& arguments,
+            const token::Token& token
+        ) override;
+
+        std::size_t arity() const override;
+    };
+
+    struct push : object::BuiltinFunction {
+        static constexpr bool PURE {false};
+
         std::shared_ptr<object::Object> call(
             Interpreter*,
             const std::vector<std::shared_ptr<object::Object>>& arguments,
@@ -81,4 +150,328 @@ namespace builtins {
 
         std::size_t arity() const override;
     };
+
+    struct pop : object::BuiltinFunction {
+        static constexpr bool PURE {false};
+
+        std::shared_ptr<object::Object> call(
+            Interpreter*,
+            const std::vector<std::shared_ptr<object::Object>>& arguments,
+            const token::Token& token
+        ) override;
+
+        std::size_t arity() const override;
+    };
+
+    struct slice : object::BuiltinFunction {
+        static constexpr bool PURE {true};
+
+        std::shared_ptr<object::Object> call(
+            Interpreter*,
+            const std::vector<std::shared_ptr<object::Object>>& arguments,
+            const token::Token& token
+        ) override;
+
+        std::size_t arity() const override;
+    };
+
+    struct get : object::BuiltinFunction {
+        static constexpr bool PURE {true};
+
+        std::shared_ptr<object::Object> call(
+            Interpreter*,
+            const std::vector<std::shared_ptr<object::Object>>& arguments,
+            const token::Token& token
+        ) override;
+
+        std::size_t arity() const override;
+    };
+
+    struct set_ : object::BuiltinFunction {
+        static constexpr bool PURE {false};
+
+        std::shared_ptr<object::Object> call(
+            Interpreter*,
+            const std::vector<std::shared_ptr<object::Object>>& arguments,
+            const token::Token& token
+        ) override;
+
+        std::size_t arity() const override;
+    };
+
+    struct has : object::BuiltinFunction {
+        static constexpr bool PURE {true};
+
+        std::shared_ptr<object::Object> call(
+            Interpreter*,
+            const std::vector<std::shared_ptr<object::Object>>& arguments,
+            const token::Token& token
+        ) override;
+
+        std::size_t arity() const override;
+    };
+
+    struct remove : object::BuiltinFunction {
+        static constexpr bool PURE {false};
+
+        std::shared_ptr<object::Object> call(
+            Interpreter*,
+            const std::vector<std::shared_ptr<object::Object>>& arguments,
+            const token::Token& token
+        ) override;
+
+        std::size_t arity() const override;
+    };
+
+    // Adding numeric arrays element-wise is pure, but purity is checked by name, before the argument types are
+    // known; it's deliberately impure as a whole because it inserts into sets, so memoized functions can't use it,
+    // not even on arrays
+    struct add : object::BuiltinFunction {
+        static constexpr bool PURE {false};
+
+        std::shared_ptr<object::Object> call(
+            Interpreter*,
+            const std::vector<std::shared_ptr<object::Object>>& arguments,
+            const token::Token& token
+        ) override;
+
+        std::size_t arity() const override;
+    };
+
+    struct keys : object::BuiltinFunction {
+        static constexpr bool PURE {true};
+
+        std::shared_ptr<object::Object> call(
+            Interpreter*,
+            const std::vector<std::shared_ptr<object::Object>>& arguments,
+            const token::Token& token
+        ) override;
+
+        std::size_t arity() const override;
+    };
+
+    struct values : object::BuiltinFunction {
+        static constexpr bool PURE {true};
+
+        std::shared_ptr<object::Object> call(
+            Interpreter*,
+            const std::vector<std::shared_ptr<object::Object>>& arguments,
+            const token::Token& token
+        ) override;
+
+        std::size_t arity() const override;
+    };
+
+    struct empty_set : object::BuiltinFunction {
+        static constexpr bool PURE {true};
+
+        std::shared_ptr<object::Object> call(
+            Interpreter*,
+            const std::vector<std::shared_ptr<object::Object>>&,
+            const token::Token&
+        ) override;
+
+        std::size_t arity() const override;
+    };
+
+    struct int_array : object::BuiltinFunction {
+        static constexpr bool PURE {true};
+
+        std::shared_ptr<object::Object> call(
+            Interpreter*,
+            const std::vector<std::shared_ptr<object::Object>>& arguments,
+            const token::Token& token
+        ) override;
+
+        std::size_t arity() const override;
+    };
+
+    struct float_array : object::BuiltinFunction {
+        static constexpr bool PURE {true};
+
+        std::shared_ptr<object::Object> call(
+            Interpreter*,
+            const std::vector<std::shared_ptr<object::Object>>& arguments,
+            const token::Token& token
+        ) override;
+
+        std::size_t arity() const override;
+    };
+
+    struct sum : object::BuiltinFunction {
+        static constexpr bool PURE {true};
+
+        std::shared_ptr<object::Object> call(
+            Interpreter*,
+            const std::vector<std::shared_ptr<object::Object>>& arguments,
+            const token::Token& token
+        ) override;
+
+        std::size_t arity() const override;
+    };
+
+    struct min : object::BuiltinFunction {
+        static constexpr bool PURE {true};
+
+        std::shared_ptr<object::Object> call(
+            Interpreter*,
+            const std::vector<std::shared_ptr<object::Object>>& arguments,
+            const token::Token& token
+        ) override;
+
+        std::size_t arity() const override;
+    };
+
+    struct max : object::BuiltinFunction {
+        static constexpr bool PURE {true};
+
+        std::shared_ptr<object::Object> call(
+            Interpreter*,
+            const std::vector<std::shared_ptr<object::Object>>& arguments,
+            const token::Token& token
+        ) override;
+
+        std::size_t arity() const override;
+    };
+
+    struct dot : object::BuiltinFunction {
+        static constexpr bool PURE {true};
+
+        std::shared_ptr<object::Object> call(
+            Interpreter*,
+            const std::vector<std::shared_ptr<object::Object>>& arguments,
+            const token::Token& token
+        ) override;
+
+        std::size_t arity() const override;
+    };
+
+    struct mul : object::BuiltinFunction {
+        static constexpr bool PURE {true};
+
+        std::shared_ptr<object::Object> call(
+            Interpreter*,
+            const std::vector<std::shared_ptr<object::Object>>& arguments,
+            const token::Token& token
+        ) override;
+
+        std::size_t arity() const override;
+    };
+
+    struct scale : object::BuiltinFunction {
+        static constexpr bool PURE {true};
+
+        std::shared_ptr<object::Object> call(
+            Interpreter*,
+            const std::vector<std::shared_ptr<object::Object>>& arguments,
+            const token::Token& token
+        ) override;
+
+        std::size_t arity() const override;
+    };
+
+    struct prefix_sum : object::BuiltinFunction {
+        static constexpr bool PURE {true};
+
+        std::shared_ptr<object::Object> call(
+            Interpreter*,
+            const std::vector<std::shared_ptr<object::Object>>& arguments,
+            const token::Token& token
+        ) override;
+
+        std::size_t arity() const override;
+    };
+
+    struct fill : object::BuiltinFunction {
+        static constexpr bool PURE {false};
+
+        std::shared_ptr<object::Object> call(
+            Interpreter*,
+            const std::vector<std::shared_ptr<object::Object>>& arguments,
+            const token::Token& token
+        ) override;
+
+        std::size_t arity() const override;
+    };
+
+    // Runs a call on the thread pool; the first argument is the callee, the rest are its arguments
+    struct spawn : object::BuiltinFunction {
+        static constexpr bool PURE {false};
+
+        std::shared_ptr<object::Object> call(
+            Interpreter* interpreter,
+            const std::vector<std::shared_ptr<object::Object>>& arguments,
+            const token::Token& token
+        ) override;
+
+        std::size_t arity() const override;
+        bool variadic() const override;
+    };
+
+    struct join : object::BuiltinFunction {
+        static constexpr bool PURE {false};
+
+        std::shared_ptr<object::Object> call(
+            Interpreter* interpreter,
+            const std::vector<std::shared_ptr<object::Object>>& arguments,
+            const token::Token& token
+        ) override;
+
+        std::size_t arity() const override;
+    };
+
+    struct channel : object::BuiltinFunction {
+        static constexpr bool PURE {false};
+
+        std::shared_ptr<object::Object> call(
+            Interpreter*,
+            const std::vector<std::shared_ptr<object::Object>>& arguments,
+            const token::Token& token
+        ) override;
+
+        std::size_t arity() const override;
+    };
+
+    struct send : object::BuiltinFunction {
+        static constexpr bool PURE {false};
+
+        std::shared_ptr<object::Object> call(
+            Interpreter* interpreter,
+            const std::vector<std::shared_ptr<object::Object>>& arguments,
+            const token::Token& token
+        ) override;
+
+        std::size_t arity() const override;
+    };
+
+    struct recv : object::BuiltinFunction {
+        static constexpr bool PURE {false};
+
+        std::shared_ptr<object::Object> call(
+            Interpreter*,
+            const std::vector<std::shared_ptr<object::Object>>& arguments,
+            const token::Token& token
+        ) override;
+
+        std::size_t arity() const override;
+    };
+
+    struct close : object::BuiltinFunction {
+        static constexpr bool PURE {false};
+
+        std::shared_ptr<object::Object> call(
+            Interpreter*,
+            const std::vector<std::shared_ptr<object::Object>>& arguments,
+            const token::Token& token
+        ) override;
+
+        std::size_t arity() const override;
+    };
+
+    // Every builtin of an interpreter, under its name
+    std::vector<std::pair<std::string, std::shared_ptr<object::Object>>> create_all();
+
+    // Builtins whose results depend on something else than their arguments or that have side effects, which memoized
+    // functions must not call; false for any other name
+    bool impure(const std::string& name);
 }
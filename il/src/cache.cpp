@@ -0,0 +1,157 @@
+#include "cache.hpp"
+
+#include <fstream>
+#include <iterator>
+#include <cstdint>
+#include <cstdio>
+#include <string_view>
+#include <string>
+#include <thread>
+#include <functional>
+
+#if defined(__unix__) || defined(__APPLE__)
+    #include <unistd.h>
+#elif defined(_WIN32)
+    #include <process.h>
+#endif
+
+#include "serialization.hpp"
+#include "version.hpp"
+
+namespace cache {
+    static constexpr std::string_view MAGIC {"ILC"};
+    static constexpr std::uint8_t FORMAT_VERSION {6u};
+
+    static void write_header(serialization::Writer& writer, const std::string& source_code) {
+        for (const char character : MAGIC) {
+            writer.write_u8(static_cast<std::uint8_t>(character));
+        }
+
+        writer.write_u8(FORMAT_VERSION);
+        writer.write_u64(VERSION_MAJOR);
+        writer.write_u64(VERSION_MINOR);
+        writer.write_u64(VERSION_PATCH);
+        writer.write_u64(source_code.size());
+        writer.write_u64(serialization::hash(source_code));
+    }
+
+    static bool check_header(serialization::Reader& reader, const std::string& source_code) {
+        for (const char character : MAGIC) {
+            if (reader.read_u8() != static_cast<std::uint8_t>(character)) {
+                return false;
+            }
+        }
+
+        if (reader.read_u8() != FORMAT_VERSION) {
+            return false;
+        }
+
+        if (reader.read_u64() != VERSION_MAJOR || reader.read_u64() != VERSION_MINOR || reader.read_u64() != VERSION_PATCH) {
+            return false;
+        }
+
+        if (reader.read_u64() != source_code.size()) {
+            return false;
+        }
+
+        return reader.read_u64() == serialization::hash(source_code);
+    }
+
+    std::string cache_path(const std::string& file_path) {
+        static constexpr std::string_view EXTENSION {".il"};
+
+        if (file_path.size() >= EXTENSION.size() && file_path.compare(file_path.size() - EXTENSION.size(), EXTENSION.size(), EXTENSION) == 0) {
+            return file_path + 'c';
+        }
+
+        return file_path + ".ilc";
+    }
+
+    std::optional<std::vector<std::shared_ptr<ast::stmt::Stmt<std::shared_ptr<object::Object>>>>> load(
+        const std::string& cache_path,
+        const std::string& source_code
+    ) {
+        std::ifstream stream {cache_path, std::ios_base::binary};
+
+        if (!stream.is_open()) {
+            return std::nullopt;
+        }
+
+        const std::string data {std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>()};
+
+        serialization::Reader reader {data};
+
+        // A stale or corrupted cache is not an error; the script is simply compiled again
+        try {
+            if (!check_header(reader, source_code)) {
+                return std::nullopt;
+            }
+
+            auto statements {serialization::read_statements(reader)};
+
+            if (!reader.reached_end()) {
+                return std::nullopt;
+            }
+
+            return statements;
+        } catch (serialization::Error) {
+            return std::nullopt;
+        }
+    }
+
+    static long long process_id() {
+#if defined(__unix__) || defined(__APPLE__)
+        return static_cast<long long>(getpid());
+#elif defined(_WIN32)
+        return static_cast<long long>(_getpid());
+#else
+        return 0ll;
+#endif
+    }
+
+    bool store(
+        const std::string& cache_path,
+        const std::string& source_code,
+        const std::vector<std::shared_ptr<ast::stmt::Stmt<std::shared_ptr<object::Object>>>>& statements
+    ) {
+        serialization::Writer writer;
+
+        try {
+            write_header(writer, source_code);
+            serialization::write_statements(writer, statements);
+        } catch (serialization::Error) {
+            return false;
+        }
+
+        // Write to a temporary file first, so that concurrent runs never see a partial cache; every thread of every
+        // process has its own, because scripts in a batch or in separate processes may store the same cache at the same
+        // time, and thread ids alone repeat across processes
+        const std::string temporary_path {
+            cache_path + "." + std::to_string(process_id()) + "."
+                + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + ".tmp"
+        };
+
+        {
+            std::ofstream stream {temporary_path, std::ios_base::binary | std::ios_base::trunc};
+
+            if (!stream.is_open()) {
+                return false;
+            }
+
+            const std::string& data {writer.get_data()};
+            stream.write(data.data(), static_cast<std::streamsize>(data.size()));
+
+            if (!stream) {
+                std::remove(temporary_path.c_str());
+                return false;
+            }
+        }
+
+        if (std::rename(temporary_path.c_str(), cache_path.c_str()) != 0) {
+            std::remove(temporary_path.c_str());
+            return false;
+        }
+
+        return true;
+    }
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <optional>
+
+#include "ast.hpp"
+#include "object.hpp"
+
+// On-disk cache of analyzed programs, stored next to the script as `script.ilc`
+// A cache file is valid only for the exact source code and interpreter version that produced it
+namespace cache {
+    std::string cache_path(const std::string& file_path);
+
+    std::optional<std::vector<std::shared_ptr<ast::stmt::Stmt<std::shared_ptr<object::Object>>>>> load(
+        const std::string& cache_path,
+        const std::string& source_code
+    );
+
+    bool store(
+        const std::string& cache_path,
+        const std::string& source_code,
+        const std::vector<std::shared_ptr<ast::stmt::Stmt<std::shared_ptr<object::Object>>>>& statements
+    );
+}
@@ -0,0 +1,124 @@
+#include "channels.hpp"
+
+#include <chrono>
+#include <utility>
+
+#include "tasks.hpp"
+
+namespace channels {
+    // Waiting threads look up every so often whether the process is exiting
+    static constexpr std::chrono::milliseconds POLL_INTERVAL {10};
+
+    Channel::Channel(std::size_t capacity)
+        : slots(capacity) {}
+
+    Status Channel::send(std::shared_ptr<object::Object> value) {
+        while (true) {
+            if (closed) {
+                return Status::Closed;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock {send_mutex};
+
+                if (try_send(value)) {
+                    changed();
+                    return Status::Done;
+                }
+            }
+
+            if (tasks::stopping()) {
+                return Status::Interrupted;
+            }
+
+            wait([this]() { return closed || tail.load() - head.load() < slots.size(); });
+        }
+    }
+
+    Status Channel::receive(std::shared_ptr<object::Object>& value) {
+        while (true) {
+            // Read before trying, so that values sent before closing are still received
+            const bool was_closed {closed};
+
+            {
+                std::lock_guard<std::mutex> lock {receive_mutex};
+
+                if (try_receive(value)) {
+                    changed();
+                    return Status::Done;
+                }
+            }
+
+            if (was_closed) {
+                return Status::Closed;
+            }
+
+            if (tasks::stopping()) {
+                return Status::Interrupted;
+            }
+
+            wait([this]() { return closed || tail.load() != head.load(); });
+        }
+    }
+
+    void Channel::close() {
+        closed = true;
+        changed();
+    }
+
+    bool Channel::try_send(std::shared_ptr<object::Object>& value) {
+        const std::size_t position {tail.load(std::memory_order_relaxed)};
+
+        if (position - head.load(std::memory_order_acquire) == slots.size()) {
+            return false;
+        }
+
+        slots[position % slots.size()] = std::move(value);
+        tail.store(position + 1u, std::memory_order_release);
+
+        return true;
+    }
+
+    bool Channel::try_receive(std::shared_ptr<object::Object>& value) {
+        const std::size_t position {head.load(std::memory_order_relaxed)};
+
+        if (position == tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        value = std::move(slots[position % slots.size()]);
+        head.store(position + 1u, std::memory_order_release);
+
+        return true;
+    }
+
+    // The waiter announces itself before checking, the other side checks for waiters after changing the counters,
+    // so that one of them always sees the other
+    template<typename Ready>
+    void Channel::wait(const Ready& ready) {
+        tasks::Blocking blocking;
+
+        waiting.fetch_add(1u);
+
+        {
+            std::unique_lock<std::mutex> lock {wait_mutex};
+            wake.wait_for(lock, POLL_INTERVAL, ready);
+        }
+
+        waiting.fetch_sub(1u);
+    }
+
+    void Channel::changed() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if (waiting.load() == 0u) {
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock {wait_mutex};
+        }
+
+        wake.notify_all();
+    }
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstddef>
+
+#include "object.hpp"
+
+// Bounded queues of values between interpreters running on different threads
+namespace channels {
+    enum class Status {
+        Done,
+        Closed,
+        Interrupted  // The process is exiting
+    };
+
+    // A single-producer single-consumer ring buffer: the sending and the receiving side only meet through the head
+    // and tail counters, without locks; several senders or receivers on the same channel take turns on their side
+    // Values must not be referenced by anything else once sent, except if they are immutable
+    class Channel {
+    public:
+        explicit Channel(std::size_t capacity);
+
+        // Block while the channel is full or empty, respectively
+        Status send(std::shared_ptr<object::Object> value);
+        Status receive(std::shared_ptr<object::Object>& value);  // Closed only once it's also drained
+
+        void close();
+    private:
+        bool try_send(std::shared_ptr<object::Object>& value);
+        bool try_receive(std::shared_ptr<object::Object>& value);
+
+        template<typename Ready>
+        void wait(const Ready& ready);
+
+        void changed();
+
+        std::vector<std::shared_ptr<object::Object>> slots;
+
+        // Both count up forever; the slot of a counter is its value modulo the capacity
+        alignas(64) std::atomic<std::size_t> head {0u};  // Next to receive, written by the receiving side
+        alignas(64) std::atomic<std::size_t> tail {0u};  // Next to send, written by the sending side
+
+        alignas(64) std::mutex send_mutex;
+        std::mutex receive_mutex;
+        std::atomic<bool> closed {false};
+
+        // Only for sleeping while full or empty
+        std::mutex wait_mutex;
+        std::condition_variable wake;
+        std::atomic<std::size_t> waiting {0u};
+    };
+}
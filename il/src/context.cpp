@@ -2,6 +2,9 @@
 
 #include <iostream>
 
+Context::Context()
+    : Context(&std::cerr) {}
+
 void Context::error(const token::Token& token, const std::string& message) {
     if (token.get_type() == token::TokenType::Eof) {
         report(token.get_line(), " at end", message);
@@ -15,11 +18,11 @@ void Context::error(std::size_t line, const std::string& message) {
 }
 
 void Context::runtime_error(const token::Token& token, const std::string& message) {
-    std::cerr << "[line " << std::to_string(token.get_line()) << "] " << message << '\n';
+    *error_stream << "[line " << std::to_string(token.get_line()) << "] " << message << '\n';
     had_runtime_error = true;
 }
 
 void Context::report(std::size_t line, const std::string& where, const std::string& message) {
-    std::cerr << "[line " << line << "] Error" << where << ": " << message << '\n';
+    *error_stream << "[line " << line << "] Error" << where << ": " << message << '\n';
     had_error = true;
 }
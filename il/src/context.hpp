@@ -2,6 +2,7 @@
 
 #include <string>
 #include <cstddef>
+#include <ostream>
 
 #include "token.hpp"
 
@@ -9,12 +10,19 @@ class Il;
 
 class Context {
 public:
+    Context();
+
+    // Errors go to the given stream instead of stderr
+    explicit Context(std::ostream* error_stream)
+        : error_stream(error_stream) {}
+
     void error(std::size_t line, const std::string& message);
     void error(const token::Token& token, const std::string& message);
     void runtime_error(const token::Token& token, const std::string& message);
 private:
     void report(std::size_t line, const std::string& where, const std::string& message);
 
+    std::ostream* error_stream {nullptr};
     bool had_error {false};
     bool had_runtime_error {false};
 
@@ -0,0 +1,156 @@
+#include "embed.hpp"
+
+#include <iostream>
+#include <utility>
+
+#include "il.hpp"
+#include "object.hpp"
+#include "token.hpp"
+#include "runtime_error.hpp"
+
+namespace embed {
+    static std::shared_ptr<object::Object> to_object(const Value& value) {
+        switch (value.index()) {
+            case 1u:
+                return object::create_bool(std::get<bool>(value));
+            case 2u:
+                return object::create_integer(std::get<long long>(value));
+            case 3u:
+                return object::create_float(std::get<double>(value));
+            case 4u:
+                return object::create_string(std::get<std::string>(value));
+            default:
+                return object::create_none();
+        }
+    }
+
+    static Value to_value(const std::shared_ptr<object::Object>& object) {
+        switch (object->type) {
+            case object::Type::None:
+                return {};
+            case object::Type::Boolean:
+                return object::cast<object::Boolean>(object)->value;
+            case object::Type::Integer:
+                return object::cast<object::Integer>(object)->value;
+            case object::Type::Float:
+                return object::cast<object::Float>(object)->value;
+            case object::Type::String:
+                return object::cast<object::String>(object)->value;
+            default:
+                throw Error("Only none, booleans, integers, floats and strings can be passed to the host");
+        }
+    }
+
+    struct HostFunction : object::BuiltinFunction {
+        static constexpr bool PURE {false};  // Nothing is known about host functions
+
+        std::shared_ptr<object::Object> call(
+            Interpreter*,
+            const std::vector<std::shared_ptr<object::Object>>& arguments,
+            const token::Token& token
+        ) override {
+            try {
+                std::vector<Value> values;
+                values.reserve(arguments.size());
+
+                for (const auto& argument : arguments) {
+                    values.push_back(to_value(argument));
+                }
+
+                return to_object(function(values));
+            } catch (const Error& e) {
+                throw RuntimeError(token, e.what());
+            }
+        }
+
+        std::size_t arity() const override {
+            return parameters;
+        }
+
+        std::size_t parameters {};
+        Function function;
+    };
+
+    struct Engine::Impl {
+        Impl(std::ostream* output_stream, std::ostream* error_stream, std::istream* input_stream)
+            : il(output_stream, error_stream, input_stream) {}
+
+        Il il;
+    };
+
+    Engine::Engine()
+        : Engine(&std::cout, &std::cerr, &std::cin) {}
+
+    Engine::Engine(std::ostream* output_stream, std::ostream* error_stream, std::istream* input_stream)
+        : impl(std::make_unique<Impl>(output_stream, error_stream, input_stream)) {}
+
+    Engine::~Engine() noexcept = default;
+
+    void Engine::define_function(const std::string& name, std::size_t arity, Function function) {
+        std::shared_ptr<object::Object> builtin {object::create_builtin_function<HostFunction>(name)};
+
+        auto host_function {object::cast<HostFunction>(builtin)};
+        host_function->parameters = arity;
+        host_function->function = std::move(function);
+
+        impl->il.get_interpreter().define_builtin(name, builtin);
+    }
+
+    void Engine::define_value(const std::string& name, const Value& value) {
+        impl->il.get_interpreter().define_builtin(name, to_object(value));
+    }
+
+    bool Engine::run_file(const std::string& file_path) {
+        const std::shared_ptr<const Program> program {impl->il.compile_file(file_path)};
+
+        return program != nullptr && impl->il.run_program(*program) == 0;
+    }
+
+    bool Engine::run_source(const std::string& source_code, const std::string& name) {
+        const std::shared_ptr<const Program> program {impl->il.compile_source(source_code, name)};
+
+        return program != nullptr && impl->il.run_program(*program) == 0;
+    }
+
+    Value Engine::call(const std::string& name, const std::vector<Value>& arguments) {
+        Interpreter& interpreter {impl->il.get_interpreter()};
+
+        const auto& values {interpreter.get_global_environment().get_values()};
+        const auto iter {values.find(name)};
+
+        if (iter == values.cend() || iter->second == nullptr || object::as_callable(iter->second) == nullptr) {
+            throw Error("`" + name + "` is not a function");
+        }
+
+        const std::shared_ptr<object::Object>& callee {iter->second};
+
+        // Errors in the callee's arguments are reported at its definition
+        const token::Token token {
+            callee->type == object::Type::Function
+                ? object::cast<object::Function>(callee)->name
+                : token::Token(token::TokenType::Identifier, name, 0u)
+        };
+
+        std::vector<std::shared_ptr<object::Object>> objects;
+        objects.reserve(arguments.size());
+
+        for (const Value& argument : arguments) {
+            objects.push_back(to_object(argument));
+        }
+
+        std::shared_ptr<object::Object> result;
+
+        try {
+            Interpreter::check_arity(token, callee, objects.size());
+            result = object::as_callable(callee)->call(&interpreter, objects, token);
+        } catch (const RuntimeError& e) {
+            interpreter.get_output().flush();
+
+            throw Error("[line " + std::to_string(e.token.get_line()) + "] " + e.message);
+        }
+
+        interpreter.get_output().flush();
+
+        return to_value(result);
+    }
+}
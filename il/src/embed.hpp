@@ -0,0 +1,68 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <variant>
+#include <functional>
+#include <stdexcept>
+#include <memory>
+#include <ostream>
+#include <istream>
+#include <cstddef>
+
+// The API for embedding IL in other programs, which doesn't expose any of the interpreter's internals
+namespace embed {
+    // Values crossing between the host and the scripts: none, booleans, integers, floats and strings
+    using Value = std::variant<std::monostate, bool, long long, double, std::string>;
+
+    // Host functions may be called from the threads of spawned tasks too
+    using Function = std::function<Value(const std::vector<Value>& arguments)>;
+
+    // Thrown by the engine for errors in the scripts; thrown by host functions, it becomes a runtime error
+    class Error : public std::runtime_error {
+    public:
+        using std::runtime_error::runtime_error;
+    };
+
+    // Typed arguments for Engine::call
+    inline Value value(std::monostate) { return {}; }
+    inline Value value(bool value) { return value; }
+    inline Value value(int value) { return static_cast<long long>(value); }
+    inline Value value(long value) { return static_cast<long long>(value); }
+    inline Value value(long long value) { return value; }
+    inline Value value(double value) { return value; }
+    inline Value value(const char* value) { return std::string(value); }
+    inline Value value(const std::string& value) { return value; }
+    inline Value value(const Value& value) { return value; }
+
+    class Engine {
+    public:
+        // Script output goes to stdout, errors to stderr and input comes from stdin
+        Engine();
+        Engine(std::ostream* output_stream, std::ostream* error_stream, std::istream* input_stream);
+        ~Engine() noexcept;
+
+        Engine(const Engine&) = delete;
+        Engine& operator=(const Engine&) = delete;
+
+        // Defined as builtins, so they outlive the programs run afterwards
+        void define_function(const std::string& name, std::size_t arity, Function function);
+        void define_value(const std::string& name, const Value& value);
+
+        // Every run starts with fresh globals; errors are reported to the error stream and make these return false
+        bool run_file(const std::string& file_path);
+        bool run_source(const std::string& source_code, const std::string& name = "<source>");
+
+        // Calls a function defined by the last program run; the output is flushed afterwards
+        Value call(const std::string& name, const std::vector<Value>& arguments);
+
+        template<typename... Arguments>
+        Value call(const std::string& name, const Arguments&... arguments) {
+            return call(name, std::vector<Value> {value(arguments)...});
+        }
+    private:
+        struct Impl;
+
+        std::unique_ptr<Impl> impl;
+    };
+}
@@ -1,32 +1,64 @@
 #include "environment.hpp"
 
 #include "runtime_error.hpp"
+#include "stats.hpp"
 
 void Environment::define(const std::string& name, std::shared_ptr<object::Object> value) {
     values[name] = value;
 }
 
 std::shared_ptr<object::Object> Environment::get(const token::Token& name) const {
-    if (values.find(name.get_lexeme()) != values.cend()) {
-        return values.at(name.get_lexeme());
-    }
+    IL_STATS(stats::counters.environment_lookups++);
+
+    for (const Environment* environment {this}; environment != nullptr; environment = environment->enclosing) {
+        IL_STATS(stats::counters.environment_depth++);
 
-    if (enclosing != nullptr) {
-        return enclosing->get(name);
+        const auto iter {environment->values.find(name.get_lexeme())};
+
+        if (iter != environment->values.cend()) {
+            return iter->second;
+        }
     }
 
-    throw RuntimeError(name, "Undefined variable `" + name.get_lexeme() + "`");
+    undefined(name);
 }
 
 void Environment::assign(const token::Token& name, std::shared_ptr<object::Object> value) {
-    if (values.find(name.get_lexeme()) != values.cend()) {
-        values.at(name.get_lexeme()) = value;
-        return;
+    IL_STATS(stats::counters.environment_lookups++);
+
+    for (Environment* environment {this}; environment != nullptr; environment = environment->enclosing) {
+        IL_STATS(stats::counters.environment_depth++);
+
+        const auto iter {environment->values.find(name.get_lexeme())};
+
+        if (iter != environment->values.end()) {
+            iter->second = value;
+            return;
+        }
     }
 
-    if (enclosing != nullptr) {
-        enclosing->assign(name, value);
-        return;
+    undefined(name);
+}
+
+void Environment::leave_out(const std::string& name, const std::string& message) {
+    if (left_out == nullptr) {
+        left_out = std::make_shared<std::unordered_map<std::string, std::string>>();
+    }
+
+    (*left_out)[name] = message;
+}
+
+void Environment::undefined(const token::Token& name) const {
+    for (const Environment* environment {this}; environment != nullptr; environment = environment->enclosing) {
+        if (environment->left_out == nullptr) {
+            continue;
+        }
+
+        const auto iter {environment->left_out->find(name.get_lexeme())};
+
+        if (iter != environment->left_out->cend()) {
+            throw RuntimeError(name, iter->second);
+        }
     }
 
     throw RuntimeError(name, "Undefined variable `" + name.get_lexeme() + "`");
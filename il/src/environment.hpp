@@ -17,7 +17,20 @@ public:
     void define(const std::string& name, std::shared_ptr<object::Object> value);
     std::shared_ptr<object::Object> get(const token::Token& name) const;
     void assign(const token::Token& name, std::shared_ptr<object::Object> value);
+
+    // Direct reference to a variable defined in this scope, which stays valid as long as the environment
+    std::shared_ptr<object::Object>& slot(const std::string& name) { return values.at(name); }
+
+    const std::unordered_map<std::string, std::shared_ptr<object::Object>>& get_values() const { return values; }
+
+    // Names deliberately left undefined; using them fails with the given message instead of as an undefined variable
+    void leave_out(const std::string& name, const std::string& message);
 private:
+    [[noreturn]] void undefined(const token::Token& name) const;
+
     std::unordered_map<std::string, std::shared_ptr<object::Object>> values;
     Environment* enclosing {nullptr};
+
+    // Null in all but the few environments that have any, as environments are created for every call and block
+    std::shared_ptr<std::unordered_map<std::string, std::string>> left_out;
 };
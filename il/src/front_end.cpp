@@ -0,0 +1,155 @@
+#include "front_end.hpp"
+
+#include <sstream>
+#include <string_view>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <iterator>
+
+#include "context.hpp"
+#include "scanner.hpp"
+#include "parser.hpp"
+#include "analyzer.hpp"
+
+namespace front_end {
+    struct Result {
+        Statements statements;
+        bool failed {false};
+    };
+
+    static bool is_word(char character) {
+        return (character >= 'A' && character <= 'Z') || (character >= 'a' && character <= 'z')
+            || (character >= '0' && character <= '9') || character == '_';
+    }
+
+    // `fun` right after `memo` belongs to the same declaration
+    static bool starts_declaration(std::string_view word, std::string_view previous) {
+        return word == "struct" || word == "memo" || (word == "fun" && previous != "memo");
+    }
+
+    // Only matches brackets, skipping strings and comments the way the scanner does; anything it gets wrong is caught
+    // by compiling the pieces, which then fails
+    std::vector<Piece> split(const std::string& source_code, std::size_t count) {
+        const std::size_t size {source_code.size()};
+        const std::size_t piece_size {std::max(size / std::max(count, std::size_t {1u}), std::size_t {1u})};
+        const std::string_view source {source_code};
+
+        std::vector<Piece> pieces {Piece {0u, size, 1u}};
+        std::string_view previous;
+        std::size_t depth {0u};
+        std::size_t line {1u};
+        std::size_t i {0u};
+
+        while (i < size) {
+            const char character {source[i]};
+
+            if (character == '\n') {
+                line++;
+                i++;
+            } else if (character == '"') {
+                // Strings have no escapes and may span lines
+                for (i++; i < size && source[i] != '"'; i++) {
+                    if (source[i] == '\n') {
+                        line++;
+                    }
+                }
+
+                i++;
+            } else if (character == '/' && i + 1u < size && source[i + 1u] == '/') {
+                while (i < size && source[i] != '\n') {
+                    i++;
+                }
+            } else if (character == '(' || character == '[' || character == '{') {
+                depth++;
+                i++;
+            } else if (character == ')' || character == ']' || character == '}') {
+                depth -= depth > 0u ? 1u : 0u;
+                i++;
+            } else if (is_word(character)) {
+                const std::size_t begin {i};
+
+                while (i < size && is_word(source[i])) {
+                    i++;
+                }
+
+                const std::string_view word {source.substr(begin, i - begin)};
+
+                if (depth == 0u && begin - pieces.back().begin >= piece_size && starts_declaration(word, previous)) {
+                    pieces.back().end = begin;
+                    pieces.push_back(Piece {begin, size, line});
+                }
+
+                previous = word;
+            } else {
+                i++;
+            }
+        }
+
+        return pieces;
+    }
+
+    // The same steps as a whole source takes in Il::compile
+    static void compile_piece(const std::string& source_code, const Piece& piece, bool lazy, Result& result) {
+        std::ostringstream errors;
+        Context ctx {&errors};
+
+        Scanner scanner {source_code.substr(piece.begin, piece.end - piece.begin), &ctx, piece.line};
+        Parser parser {scanner.scan(), &ctx, lazy};
+
+        result.statements = parser.parse<std::shared_ptr<object::Object>>();
+
+        if (errors.str().empty()) {
+            Analyzer analyzer {&ctx};
+            analyzer.analyze(result.statements);
+        }
+
+        result.failed = !errors.str().empty();
+    }
+
+    std::optional<Statements> compile(const std::string& source_code, unsigned int jobs, bool lazy) {
+        // More pieces than threads, so that the threads finishing early take over the rest
+        const std::vector<Piece> pieces {split(source_code, static_cast<std::size_t>(jobs) * 4u)};
+        std::vector<Result> results(pieces.size());
+        std::atomic<std::size_t> next {0u};
+
+        const auto work {[&]() {
+            for (std::size_t i {next.fetch_add(1u)}; i < pieces.size(); i = next.fetch_add(1u)) {
+                compile_piece(source_code, pieces[i], lazy, results[i]);
+            }
+        }};
+
+        std::vector<std::thread> threads;
+        const std::size_t count {std::min(static_cast<std::size_t>(jobs), pieces.size())};
+
+        // The calling thread works too
+        for (std::size_t i {1u}; i < count; i++) {
+            threads.emplace_back(work);
+        }
+
+        work();
+
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+
+        std::size_t total {0u};
+
+        for (const Result& result : results) {
+            if (result.failed) {
+                return std::nullopt;
+            }
+
+            total += result.statements.size();
+        }
+
+        Statements statements;
+        statements.reserve(total);
+
+        for (Result& result : results) {
+            std::move(result.statements.begin(), result.statements.end(), std::back_inserter(statements));
+        }
+
+        return statements;
+    }
+}
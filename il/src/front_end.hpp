@@ -0,0 +1,35 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <optional>
+#include <cstddef>
+
+#include "ast.hpp"
+#include "object.hpp"
+
+// Scanning, parsing and analyzing large sources on several threads
+// Functions and structs can only be declared at the top level, so the source can be cut right before any of them and
+// every piece compiled on its own
+namespace front_end {
+    using Statements = std::vector<std::shared_ptr<ast::stmt::Stmt<std::shared_ptr<object::Object>>>>;
+
+    // Smaller sources aren't worth starting threads for
+    inline constexpr std::size_t MIN_PARALLEL_SIZE {256u * 1024u};
+
+    struct Piece {
+        std::size_t begin {0u};
+        std::size_t end {0u};
+        std::size_t line {1u};  // Line of the first character
+    };
+
+    // Cuts the source into about the given number of pieces of similar size, in source order; a source without
+    // declarations at the top level stays whole
+    std::vector<Piece> split(const std::string& source_code, std::size_t count);
+
+    // The statements of all pieces, merged in source order, or nothing if any piece has errors
+    // Errors aren't reported, as a piece on its own may get different ones than the whole source; callers compile the
+    // whole source again instead, so that they report exactly what a single thread would
+    std::optional<Statements> compile(const std::string& source_code, unsigned int jobs, bool lazy);
+}
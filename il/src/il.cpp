@@ -10,34 +10,127 @@
 #include "object.hpp"
 #include "ast_printer.hpp"  // TODO temporary
 #include "analyzer.hpp"
-
-static constexpr unsigned int VERSION_MAJOR {0u};
-static constexpr unsigned int VERSION_MINOR {1u};
-static constexpr unsigned int VERSION_PATCH {0u};
+#include "front_end.hpp"
+#include "cache.hpp"
+#include "image.hpp"
+#include "lines.hpp"
+#include "profiler.hpp"
+#include "stats.hpp"
+#include "version.hpp"
+
+Il::Il()
+    : Il(&std::cout) {}
+
+Il::Il(std::ostream* output_stream)
+    : Il(output_stream, &std::cerr, &std::cin) {}
+
+Il::Il(std::ostream* output_stream, std::ostream* error_stream, std::istream* input_stream)
+    : output_stream(output_stream),
+      error_stream(error_stream),
+      input_stream(input_stream),
+      ctx(error_stream),
+      interpreter(&ctx, output_stream, input_stream) {}
 
 int Il::run_file(const std::string& file_path) {
+    const std::shared_ptr<const Program> program {compile_file(file_path)};
+
+    if (program == nullptr) {
+        return 1;
+    }
+
+    return run_program(*program);
+}
+
+std::shared_ptr<const Program> Il::compile_file(const std::string& file_path) {
     const auto contents {read_file(file_path)};
 
     if (!contents) {
-        std::cerr << "il: could not read file `" << file_path << "`\n";
-        return 1;
+        *error_stream << "il: could not read file `" << file_path << "`\n";
+        return nullptr;
     }
 
-    run(*contents);
+    std::optional<Program::Statements> statements;
 
-    if (ctx.had_error) {
+    if (use_cache) {
+        const std::string path {cache::cache_path(file_path)};
+
+        statements = cache::load(path, *contents);
+
+        if (!statements) {
+            statements = compile(*contents);
+
+            if (statements) {
+                cache::store(path, *contents, *statements);  // Failing to write the cache is not fatal
+            }
+        }
+    } else {
+        statements = compile(*contents);
+    }
+
+    if (!statements) {
+        return nullptr;
+    }
+
+    return std::make_shared<const Program>(std::move(*statements), file_path);
+}
+
+std::shared_ptr<const Program> Il::compile_source(const std::string& source_code, const std::string& name) {
+    auto statements {compile(source_code)};
+
+    if (!statements) {
+        return nullptr;
+    }
+
+    return std::make_shared<const Program>(std::move(*statements), name);
+}
+
+int Il::run_program(const Program& program) {
+    return launch(program, [this, &program]() {
+        interpreter.interpret(program.get_statements());
+    });
+}
+
+int Il::run_lines(const Program& program, std::istream& stream) {
+    return launch(program, [this, &program, &stream]() {
+        interpreter.interpret(program.get_statements());
+
+        if (!ctx.had_runtime_error) {
+            stream_lines(stream);
+        }
+    });
+}
+
+int Il::launch(const Program& program, const std::function<void()>& body) {
+    ctx.had_error = false;
+    ctx.had_runtime_error = false;
+
+    interpreter.reset();
+
+    if (!image_path.empty() && !image::load(image_path, interpreter)) {
+        *error_stream << "il: could not load image `" << image_path << "`\n";
         return 1;
     }
 
+    execute(body, program.get_file_path());
+
+    if (stats) {
+        stats::report(*error_stream);
+    }
+
     if (ctx.had_runtime_error) {
         return 1;
     }
 
+    if (!snapshot_path.empty() && !image::store(snapshot_path, interpreter)) {
+        *error_stream << "il: could not store image `" << snapshot_path << "`\n";
+        return 1;
+    }
+
     return 0;
 }
 
 int Il::run_repl() {
-    std::cout << (
+    *output_stream << (
 R"(
 _________ _            _        _______  _        _______ 
 \__   __/( \          ( \      (  ___  )( (    /|(  ____ \
@@ -50,21 +143,21 @@ ___) (___| (____/\    | (____/\| )   ( || )  \  || (___) |
 )"
     );
 
-    std::cout << "\nIL version " << VERSION_MAJOR << '.' << VERSION_MINOR << '.' << VERSION_PATCH << "\n\n";
+    *output_stream << "\nIL version " << VERSION_MAJOR << '.' << VERSION_MINOR << '.' << VERSION_PATCH << "\n\n";
 
     while (true) {
-        std::cout << ">> ";
+        *output_stream << ">> ";
 
         std::string line;
-        std::getline(std::cin, line);
+        std::getline(*input_stream, line);
 
-        if (std::cin.eof()) {
-            std::cout << std::endl;
+        if (input_stream->eof()) {
+            *output_stream << std::endl;
             break;
         }
 
-        if (std::cin.bad()) {
-            std::cin.clear();
+        if (input_stream->bad()) {
+            input_stream->clear();
             continue;
         }
 
@@ -80,36 +173,161 @@ ___) (___| (____/\    | (____/\| )   ( || )  \  || (___) |
     return 0;
 }
 
+void Il::set_output_buffer_size(std::size_t size) {
+    interpreter.get_output().set_capacity(size);
+}
+
+void Il::execute(const std::function<void()>& body, const std::string& file_path) {
+    std::unique_ptr<profiler::Sampler> sampler;
+    std::unique_ptr<profiler::Tracer> tracer;
+
+    if (profile || !profile_folded_path.empty()) {
+        sampler = std::make_unique<profiler::Sampler>();
+
+        if (sampler->start()) {
+            interpreter.set_sampler(sampler.get());
+        } else {
+            *error_stream << "il: could not start the profiler\n";
+            sampler.reset();
+        }
+    }
+
+    if (!callgraph_path.empty() || !callgraph_folded_path.empty()) {
+        tracer = std::make_unique<profiler::Tracer>();
+        tracer->start();
+        interpreter.set_tracer(tracer.get());
+    }
+
+    body();
+
+    if (tracer != nullptr) {
+        tracer->stop();
+        interpreter.set_tracer(nullptr);
+
+        write_file(callgraph_path, [&](std::ostream& stream) { tracer->write_callgrind(stream, file_path); });
+        write_file(callgraph_folded_path, [&](std::ostream& stream) { tracer->write_folded(stream); });
+    }
+
+    if (sampler != nullptr) {
+        sampler->stop();
+        interpreter.set_sampler(nullptr);
+
+        if (profile) {
+            sampler->report(*error_stream);
+        }
+
+        write_file(profile_folded_path, [&](std::ostream& stream) { sampler->write_folded(stream); });
+    }
+}
+
+void Il::stream_lines(std::istream& stream) {
+    const std::shared_ptr<object::Function> on_line {hook("on_line")};
+
+    if (on_line == nullptr) {
+        *error_stream << "il: the script doesn't define the function `on_line(line)`\n";
+        ctx.had_runtime_error = true;
+        return;
+    }
+
+    const std::shared_ptr<object::Function> begin {hook("begin")};
+    const std::shared_ptr<object::Function> end {hook("end")};
+
+    if (begin != nullptr && !interpreter.call(begin, {})) {
+        return;
+    }
+
+    LineReader reader {&stream};
+    std::string line;
+    std::vector<std::shared_ptr<object::Object>> arguments(1u);
+
+    while (reader.next(line)) {
+        arguments[0u] = object::create_string(line);
+
+        if (!interpreter.call(on_line, arguments)) {
+            return;
+        }
+    }
+
+    if (end != nullptr && !interpreter.call(end, {})) {
+        return;
+    }
+
+    interpreter.get_output().flush();
+}
+
+std::shared_ptr<object::Function> Il::hook(const std::string& name) {
+    const auto& values {interpreter.get_global_environment().get_values()};
+    const auto iter {values.find(name)};
+
+    if (iter == values.cend() || iter->second == nullptr || iter->second->type != object::Type::Function) {
+        return nullptr;
+    }
+
+    return object::cast<object::Function>(iter->second);
+}
+
+void Il::write_file(const std::string& file_path, const std::function<void(std::ostream&)>& write) {
+    if (file_path.empty()) {
+        return;
+    }
+
+    std::ofstream stream {file_path};
+
+    if (stream.is_open()) {
+        write(stream);
+    } else {
+        *error_stream << "il: could not write file `" << file_path << "`\n";
+    }
+}
+
 void Il::run(const std::string& source_code) {
-    Scanner scanner {source_code, &ctx};
-    const auto tokens {scanner.scan()};
+    const auto statements {compile(source_code)};
+
+    if (!statements) {
+        return;
+    }
+
+    interpreter.interpret(*statements);
+}
+
+std::optional<std::vector<std::shared_ptr<ast::stmt::Stmt<std::shared_ptr<object::Object>>>>> Il::compile(const std::string& source_code) {
+    if (front_end_jobs > 1u && source_code.size() >= front_end::MIN_PARALLEL_SIZE) {
+        auto statements {front_end::compile(source_code, front_end_jobs, lazy)};
+
+        if (statements) {
+            return statements;
+        }
 
-    Parser parser {tokens, &ctx};
+        // Compiling again on this thread reports the errors
+    }
+
+    Scanner scanner {source_code, &ctx};
+    Parser parser {scanner.scan(), &ctx, lazy};
 
 #if 0
     const auto expr {parser.parse<std::string>()};
 
     if (ctx.had_error) {
-        return;
+        return std::nullopt;
     }
 
-    std::cout << AstPrinter().print(expr) << '\n';
+    *output_stream << AstPrinter().print(expr) << '\n';
 #endif
 
-    const auto statements {parser.parse<std::shared_ptr<object::Object>>()};
+    auto statements {parser.parse<std::shared_ptr<object::Object>>()};
 
     if (ctx.had_error) {
-        return;
+        return std::nullopt;
     }
 
     Analyzer analyzer {&ctx};
     analyzer.analyze(statements);
 
     if (ctx.had_error) {
-        return;
+        return std::nullopt;
     }
 
-    interpreter.interpret(statements);
+    return statements;
 }
 
 std::optional<std::string> Il::read_file(const std::string& file_path) {
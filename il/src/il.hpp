@@ -2,21 +2,79 @@
 
 #include <string>
 #include <optional>
+#include <cstddef>
+#include <vector>
+#include <memory>
+#include <ostream>
+#include <istream>
+#include <functional>
 
 #include "context.hpp"
 #include "interpreter.hpp"
+#include "program.hpp"
 
 class Il {
 public:
-    Il()
-        : interpreter(&ctx) {}
+    Il();
+
+    // Script output goes to the given stream instead of stdout
+    explicit Il(std::ostream* output_stream);
+
+    // Nothing is read from or written to the standard streams, so instances can run on separate threads
+    Il(std::ostream* output_stream, std::ostream* error_stream, std::istream* input_stream);
 
     int run_file(const std::string& file_path);
     int run_repl();
+
+    // Compiling once and running many times; every run starts with fresh globals
+    // Programs can be shared by several instances, including on different threads at the same time
+    std::shared_ptr<const Program> compile_file(const std::string& file_path);  // Null on errors
+    std::shared_ptr<const Program> compile_source(const std::string& source_code, const std::string& name);
+    int run_program(const Program& program);
+
+    // Runs the program, then calls its `begin()` and `end()` functions, if defined, around calling `on_line(line)`
+    // for every line of the stream
+    int run_lines(const Program& program, std::istream& stream);
+
+    Interpreter& get_interpreter() { return interpreter; }
+
+    void set_output_buffer_size(std::size_t size);
+    void set_arguments(const std::vector<std::string>& arguments) { interpreter.set_arguments(arguments); }
+    void set_use_cache(bool use_cache) { this->use_cache = use_cache; }
+    void set_lazy(bool lazy) { this->lazy = lazy; }
+    void set_front_end_jobs(unsigned int front_end_jobs) { this->front_end_jobs = front_end_jobs; }
+    void set_image_path(const std::string& image_path) { this->image_path = image_path; }
+    void set_snapshot_path(const std::string& snapshot_path) { this->snapshot_path = snapshot_path; }
+    void set_profile(bool profile) { this->profile = profile; }
+    void set_profile_folded_path(const std::string& profile_folded_path) { this->profile_folded_path = profile_folded_path; }
+    void set_stats(bool stats) { this->stats = stats; }
+    void set_callgraph_path(const std::string& callgraph_path) { this->callgraph_path = callgraph_path; }
+    void set_callgraph_folded_path(const std::string& callgraph_folded_path) { this->callgraph_folded_path = callgraph_folded_path; }
 private:
+    int launch(const Program& program, const std::function<void()>& body);
+    void execute(const std::function<void()>& body, const std::string& file_path);
+    void stream_lines(std::istream& stream);
+    std::shared_ptr<object::Function> hook(const std::string& name);  // Null if there is no such function
     void run(const std::string& source_code);
+    std::optional<std::vector<std::shared_ptr<ast::stmt::Stmt<std::shared_ptr<object::Object>>>>> compile(const std::string& source_code);
     std::optional<std::string> read_file(const std::string& file_path);
+    void write_file(const std::string& file_path, const std::function<void(std::ostream&)>& write);  // Does nothing for an empty path
+
+    std::ostream* output_stream {nullptr};
+    std::ostream* error_stream {nullptr};
+    std::istream* input_stream {nullptr};
 
     Context ctx;
     Interpreter interpreter;
+
+    bool use_cache {false};
+    bool lazy {false};  // Compile function bodies on their first call
+    unsigned int front_end_jobs {1u};  // Threads compiling large sources
+    std::string image_path;  // Heap image loaded before running
+    std::string snapshot_path;  // Heap image stored after running
+    bool profile {false};  // Print the sampling profiler's report to stderr
+    std::string profile_folded_path;  // Folded stacks of the sampling profiler
+    bool stats {false};  // Print the runtime statistics to stderr
+    std::string callgraph_path;  // Callgrind file of the tracing profiler
+    std::string callgraph_folded_path;  // Folded stacks of the tracing profiler
 };
@@ -0,0 +1,715 @@
+#include "image.hpp"
+
+#include <fstream>
+#include <iterator>
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <map>
+#include <memory>
+#include <utility>
+
+#include "interpreter.hpp"
+#include "environment.hpp"
+#include "object.hpp"
+#include "memo.hpp"
+#include "serialization.hpp"
+#include "lazy.hpp"
+#include "runtime_error.hpp"
+#include "version.hpp"
+
+namespace image {
+    static constexpr std::string_view MAGIC {"ILI"};
+    static constexpr std::uint8_t FORMAT_VERSION {6u};
+
+    using Body = std::vector<std::shared_ptr<ast::stmt::Stmt<std::shared_ptr<object::Object>>>>;
+
+    // Objects are numbered in discovery order; references are stored as index + 1, with 0 meaning null
+    class ImageWriter {
+    public:
+        explicit ImageWriter(serialization::Writer* writer)
+            : writer(writer) {}
+
+        void write(const Environment& environment);
+    private:
+        void collect(const std::shared_ptr<object::Object>& object);
+        std::size_t collect_body(const Body& body);
+        std::uint64_t reference(const std::shared_ptr<object::Object>& object) const;
+        void write_object(const std::shared_ptr<object::Object>& object);
+        void write_links(const std::shared_ptr<object::Object>& object);
+
+        std::vector<std::shared_ptr<object::Object>> objects;
+        std::unordered_map<const object::Object*, std::size_t> indices;
+
+        // Methods of every instance are copies sharing the same syntax tree, so bodies are stored only once
+        std::vector<const Body*> bodies;
+        std::map<std::vector<const void*>, std::size_t> body_indices;
+
+        serialization::Writer* writer {nullptr};
+    };
+
+    class ImageReader {
+    public:
+        ImageReader(serialization::Reader* reader, Interpreter* interpreter)
+            : reader(reader), interpreter(interpreter) {}
+
+        void read(Environment& environment);
+    private:
+        std::size_t read_size();
+        std::shared_ptr<object::Object> read_reference();
+        std::shared_ptr<object::Object> read_object();
+        void read_links(const std::shared_ptr<object::Object>& object);
+        void read_function(object::Function& function);
+
+        std::vector<std::shared_ptr<object::Object>> objects;
+        std::vector<Body> bodies;
+
+        serialization::Reader* reader {nullptr};
+        Interpreter* interpreter {nullptr};
+    };
+
+    // Lazy bodies are compiled first; the ones that don't compile can't be stored
+    static const Body& function_body(const object::Function& function) {
+        try {
+            return lazy::body(function);
+        } catch (const RuntimeError&) {
+            throw serialization::Error();
+        }
+    }
+
+    void ImageWriter::write(const Environment& environment) {
+        for (const auto& [_, value] : environment.get_values()) {
+            collect(value);
+        }
+
+        writer->write_u64(bodies.size());
+
+        for (const Body* body : bodies) {
+            serialization::write_statements(*writer, *body);
+        }
+
+        writer->write_u64(objects.size());
+
+        for (const auto& object : objects) {
+            write_object(object);
+        }
+
+        for (const auto& object : objects) {
+            write_links(object);
+        }
+
+        writer->write_u64(environment.get_values().size());
+
+        for (const auto& [name, value] : environment.get_values()) {
+            writer->write_string(name);
+            writer->write_u64(reference(value));
+        }
+    }
+
+    void ImageWriter::collect(const std::shared_ptr<object::Object>& object) {
+        if (object == nullptr || indices.find(object.get()) != indices.cend()) {
+            return;
+        }
+
+        indices[object.get()] = objects.size();
+        objects.push_back(object);
+
+        switch (object->type) {
+            case object::Type::Function:
+                collect_body(function_body(*object::cast<object::Function>(object)));
+                break;
+            case object::Type::Method: {
+                auto method {object::cast<object::Method>(object)};
+
+                collect_body(function_body(*method));
+                collect(method->instance);
+
+                break;
+            }
+            case object::Type::Struct:
+                for (const auto& [_, method] : object::cast<object::Struct>(object)->methods) {
+                    collect(method);
+                }
+
+                break;
+            case object::Type::StructInstance: {
+                auto instance {object::cast<object::StructInstance>(object)};
+
+                collect(instance->struct_);
+
+                for (const auto& [_, method] : instance->methods) {
+                    collect(method);
+                }
+
+                for (const auto& [_, field] : instance->fields) {
+                    collect(field);
+                }
+
+                break;
+            }
+            case object::Type::Array:
+                for (const auto& element : object::cast<object::Array>(object)->elements) {
+                    collect(element);
+                }
+
+                break;
+            case object::Type::Map:
+                object::cast<object::Map>(object)->entries.for_each(
+                    [&](const std::shared_ptr<object::Object>& key, const std::shared_ptr<object::Object>& value) {
+                        collect(key);
+                        collect(value);
+                    }
+                );
+
+                break;
+            case object::Type::Set:
+                object::cast<object::Set>(object)->elements.for_each(
+                    [&](const std::shared_ptr<object::Object>& element, const std::shared_ptr<object::Object>&) {
+                        collect(element);
+                    }
+                );
+
+                break;
+            default:
+                break;
+        }
+    }
+
+    std::size_t ImageWriter::collect_body(const Body& body) {
+        std::vector<const void*> key;
+
+        for (const auto& statement : body) {
+            key.push_back(statement.get());
+        }
+
+        const auto iter {body_indices.find(key)};
+
+        if (iter != body_indices.cend()) {
+            return iter->second;
+        }
+
+        const std::size_t index {bodies.size()};
+
+        body_indices[std::move(key)] = index;
+        bodies.push_back(&body);
+
+        return index;
+    }
+
+    std::uint64_t ImageWriter::reference(const std::shared_ptr<object::Object>& object) const {
+        if (object == nullptr) {
+            return 0u;
+        }
+
+        return indices.at(object.get()) + 1u;
+    }
+
+    void ImageWriter::write_object(const std::shared_ptr<object::Object>& object) {
+        writer->write_u8(static_cast<std::uint8_t>(object->type));
+
+        switch (object->type) {
+            case object::Type::None:
+            case object::Type::String:
+            case object::Type::Integer:
+            case object::Type::Float:
+            case object::Type::Boolean:
+                writer->write_literal(object);
+                break;
+            case object::Type::BuiltinFunction:
+                writer->write_string(object::cast<object::BuiltinFunction>(object)->name);
+                break;
+            case object::Type::Function:
+            case object::Type::Method: {
+                auto function {object::cast<object::Function>(object)};
+
+                writer->write_token(function->name);
+                writer->write_u64(function->parameters.size());
+
+                for (const token::Token& parameter : function->parameters) {
+                    writer->write_token(parameter);
+                }
+
+                writer->write_u64(collect_body(function_body(*function)));
+                writer->write_u8(function->memo != nullptr ? 1u : 0u);  // The cached results are not stored
+
+                break;
+            }
+            case object::Type::Struct:
+                writer->write_string(object::cast<object::Struct>(object)->name);
+                break;
+            case object::Type::StructInstance:
+            case object::Type::Array:
+            case object::Type::Map:
+            case object::Type::Set:
+                break;
+            case object::Type::IntArray: {
+                const auto& values {object::cast<object::IntArray>(object)->values};
+
+                writer->write_u64(values.size());
+
+                for (const long long value : values) {
+                    writer->write_i64(value);
+                }
+
+                break;
+            }
+            case object::Type::FloatArray: {
+                const auto& values {object::cast<object::FloatArray>(object)->values};
+
+                writer->write_u64(values.size());
+
+                for (const double value : values) {
+                    writer->write_f64(value);
+                }
+
+                break;
+            }
+            case object::Type::Task:
+            case object::Type::Channel:
+                throw serialization::Error();  // Neither can be shared with a later process
+        }
+    }
+
+    void ImageWriter::write_links(const std::shared_ptr<object::Object>& object) {
+        switch (object->type) {
+            case object::Type::Method:
+                writer->write_u64(reference(object::cast<object::Method>(object)->instance));
+                break;
+            case object::Type::Struct: {
+                auto struct_ {object::cast<object::Struct>(object)};
+
+                writer->write_u64(struct_->methods.size());
+
+                for (const auto& [name, method] : struct_->methods) {
+                    writer->write_string(name);
+                    writer->write_u64(reference(method));
+                }
+
+                break;
+            }
+            case object::Type::StructInstance: {
+                auto instance {object::cast<object::StructInstance>(object)};
+
+                writer->write_u64(reference(instance->struct_));
+                writer->write_u64(instance->methods.size());
+
+                for (const auto& [name, method] : instance->methods) {
+                    writer->write_string(name);
+                    writer->write_u64(reference(method));
+                }
+
+                writer->write_u64(instance->fields.size());
+
+                for (const auto& [name, field] : instance->fields) {
+                    writer->write_string(name);
+                    writer->write_u64(reference(field));
+                }
+
+                break;
+            }
+            case object::Type::Array: {
+                auto array {object::cast<object::Array>(object)};
+
+                writer->write_u64(array->elements.size());
+
+                for (const auto& element : array->elements) {
+                    writer->write_u64(reference(element));
+                }
+
+                break;
+            }
+            case object::Type::Map: {
+                const table::Table& entries {object::cast<object::Map>(object)->entries};
+
+                writer->write_u64(entries.size());
+
+                entries.for_each([&](const std::shared_ptr<object::Object>& key, const std::shared_ptr<object::Object>& value) {
+                    writer->write_u64(reference(key));
+                    writer->write_u64(reference(value));
+                });
+
+                break;
+            }
+            case object::Type::Set: {
+                const table::Table& elements {object::cast<object::Set>(object)->elements};
+
+                writer->write_u64(elements.size());
+
+                elements.for_each([&](const std::shared_ptr<object::Object>& element, const std::shared_ptr<object::Object>&) {
+                    writer->write_u64(reference(element));
+                });
+
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    void ImageReader::read(Environment& environment) {
+        const std::size_t bodies_size {read_size()};
+
+        for (std::size_t i {0u}; i < bodies_size; i++) {
+            bodies.push_back(serialization::read_statements(*reader));
+        }
+
+        const std::size_t objects_size {read_size()};
+
+        for (std::size_t i {0u}; i < objects_size; i++) {
+            objects.push_back(read_object());
+        }
+
+        for (const auto& object : objects) {
+            read_links(object);
+        }
+
+        const std::size_t globals_size {read_size()};
+
+        for (std::size_t i {0u}; i < globals_size; i++) {
+            const std::string name {reader->read_string()};
+
+            environment.define(name, read_reference());
+        }
+    }
+
+    std::size_t ImageReader::read_size() {
+        const std::uint64_t size {reader->read_u64()};
+
+        if (size > reader->remaining()) {
+            throw serialization::Error();
+        }
+
+        return static_cast<std::size_t>(size);
+    }
+
+    std::shared_ptr<object::Object> ImageReader::read_reference() {
+        const std::uint64_t reference {reader->read_u64()};
+
+        if (reference == 0u) {
+            return nullptr;
+        }
+
+        if (reference > objects.size()) {
+            throw serialization::Error();
+        }
+
+        return objects[static_cast<std::size_t>(reference - 1u)];
+    }
+
+    std::shared_ptr<object::Object> ImageReader::read_object() {
+        const auto type {static_cast<object::Type>(reader->read_u8())};
+
+        switch (type) {
+            case object::Type::None:
+            case object::Type::String:
+            case object::Type::Integer:
+            case object::Type::Float:
+            case object::Type::Boolean: {
+                auto object {reader->read_literal()};
+
+                if (object->type != type) {
+                    throw serialization::Error();
+                }
+
+                return object;
+            }
+            case object::Type::BuiltinFunction: {
+                auto builtin {interpreter->get_builtin(reader->read_string())};
+
+                if (builtin == nullptr) {
+                    throw serialization::Error();
+                }
+
+                return builtin;
+            }
+            case object::Type::Function: {
+                auto function {std::make_shared<object::Function>(reader->read_token())};
+                function->type = object::Type::Function;
+                read_function(*function);
+
+                return function;
+            }
+            case object::Type::Method: {
+                auto method {std::make_shared<object::Method>(reader->read_token())};
+                method->type = object::Type::Method;
+                read_function(*method);
+
+                return method;
+            }
+            case object::Type::Struct: {
+                auto struct_ {std::make_shared<object::Struct>()};
+                struct_->type = object::Type::Struct;
+                struct_->name = reader->read_string();
+
+                return struct_;
+            }
+            case object::Type::StructInstance: {
+                auto instance {std::make_shared<object::StructInstance>()};
+                instance->type = object::Type::StructInstance;
+
+                return instance;
+            }
+            case object::Type::Array: {
+                auto array {std::make_shared<object::Array>()};
+                array->type = object::Type::Array;
+
+                return array;
+            }
+            case object::Type::Map: {
+                auto map {std::make_shared<object::Map>()};
+                map->type = object::Type::Map;
+
+                return map;
+            }
+            case object::Type::Set: {
+                auto set {std::make_shared<object::Set>()};
+                set->type = object::Type::Set;
+
+                return set;
+            }
+            case object::Type::IntArray: {
+                auto array {std::make_shared<object::IntArray>()};
+                array->type = object::Type::IntArray;
+
+                const std::size_t size {read_size()};
+
+                for (std::size_t i {0u}; i < size; i++) {
+                    array->values.push_back(reader->read_i64());
+                }
+
+                return array;
+            }
+            case object::Type::FloatArray: {
+                auto array {std::make_shared<object::FloatArray>()};
+                array->type = object::Type::FloatArray;
+
+                const std::size_t size {read_size()};
+
+                for (std::size_t i {0u}; i < size; i++) {
+                    array->values.push_back(reader->read_f64());
+                }
+
+                return array;
+            }
+            case object::Type::Task:
+            case object::Type::Channel:
+                break;
+        }
+
+        throw serialization::Error();
+    }
+
+    void ImageReader::read_function(object::Function& function) {
+        const std::size_t parameters_size {read_size()};
+
+        for (std::size_t i {0u}; i < parameters_size; i++) {
+            function.parameters.push_back(reader->read_token());
+        }
+
+        const std::uint64_t body {reader->read_u64()};
+
+        if (body >= bodies.size()) {
+            throw serialization::Error();
+        }
+
+        function.body = bodies[static_cast<std::size_t>(body)];
+
+        if (reader->read_u8() != 0u) {
+            function.memo = std::make_shared<memo::Table>();
+        }
+    }
+
+    void ImageReader::read_links(const std::shared_ptr<object::Object>& object) {
+        // References must point to objects of the right type, otherwise the casts would be invalid
+        const auto read_typed {[this](object::Type type) {
+            auto object {read_reference()};
+
+            if (object != nullptr && object->type != type) {
+                throw serialization::Error();
+            }
+
+            return object;
+        }};
+
+        switch (object->type) {
+            case object::Type::Method:
+                object::cast<object::Method>(object)->instance = read_typed(object::Type::StructInstance);
+                break;
+            case object::Type::Struct: {
+                auto struct_ {object::cast<object::Struct>(object)};
+
+                const std::size_t size {read_size()};
+
+                for (std::size_t i {0u}; i < size; i++) {
+                    const std::string name {reader->read_string()};
+
+                    struct_->methods[name] = object::cast<object::Method>(read_typed(object::Type::Method));
+                }
+
+                break;
+            }
+            case object::Type::StructInstance: {
+                auto instance {object::cast<object::StructInstance>(object)};
+
+                instance->struct_ = object::cast<object::Struct>(read_typed(object::Type::Struct));
+
+                if (instance->struct_ == nullptr) {
+                    throw serialization::Error();
+                }
+
+                const std::size_t methods_size {read_size()};
+
+                for (std::size_t i {0u}; i < methods_size; i++) {
+                    const std::string name {reader->read_string()};
+
+                    instance->methods[name] = object::cast<object::Method>(read_typed(object::Type::Method));
+                }
+
+                const std::size_t fields_size {read_size()};
+
+                for (std::size_t i {0u}; i < fields_size; i++) {
+                    const std::string name {reader->read_string()};
+
+                    instance->fields[name] = read_reference();
+                }
+
+                break;
+            }
+            case object::Type::Array: {
+                auto array {object::cast<object::Array>(object)};
+
+                const std::size_t size {read_size()};
+
+                for (std::size_t i {0u}; i < size; i++) {
+                    auto element {read_reference()};
+
+                    if (element == nullptr) {
+                        throw serialization::Error();
+                    }
+
+                    array->elements.push_back(element);
+                }
+
+                break;
+            }
+            case object::Type::Map: {
+                auto map {object::cast<object::Map>(object)};
+
+                const std::size_t size {read_size()};
+
+                // Hashes are not stored, as they may differ between builds
+                for (std::size_t i {0u}; i < size; i++) {
+                    auto key {read_reference()};
+                    auto value {read_reference()};
+                    std::size_t hash {};
+
+                    if (key == nullptr || value == nullptr || !table::hash(*key, hash)) {
+                        throw serialization::Error();
+                    }
+
+                    map->entries.insert(key, hash, value);
+                }
+
+                break;
+            }
+            case object::Type::Set: {
+                auto set {object::cast<object::Set>(object)};
+
+                const std::size_t size {read_size()};
+
+                for (std::size_t i {0u}; i < size; i++) {
+                    auto element {read_reference()};
+                    std::size_t hash {};
+
+                    if (element == nullptr || !table::hash(*element, hash)) {
+                        throw serialization::Error();
+                    }
+
+                    set->elements.insert(element, hash, nullptr);
+                }
+
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    bool store(const std::string& image_path, Interpreter& interpreter) {
+        serialization::Writer writer;
+
+        for (const char character : MAGIC) {
+            writer.write_u8(static_cast<std::uint8_t>(character));
+        }
+
+        writer.write_u8(FORMAT_VERSION);
+        writer.write_u64(VERSION_MAJOR);
+        writer.write_u64(VERSION_MINOR);
+        writer.write_u64(VERSION_PATCH);
+
+        try {
+            ImageWriter(&writer).write(interpreter.get_global_environment());
+        } catch (serialization::Error) {
+            return false;
+        }
+
+        std::ofstream stream {image_path, std::ios_base::binary | std::ios_base::trunc};
+
+        if (!stream.is_open()) {
+            return false;
+        }
+
+        const std::string& data {writer.get_data()};
+        stream.write(data.data(), static_cast<std::streamsize>(data.size()));
+
+        return static_cast<bool>(stream);
+    }
+
+    bool load(const std::string& image_path, Interpreter& interpreter) {
+        std::ifstream stream {image_path, std::ios_base::binary};
+
+        if (!stream.is_open()) {
+            return false;
+        }
+
+        const std::string data {std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>()};
+
+        serialization::Reader reader {data};
+
+        // Read everything into a separate environment, so that a bad image leaves the interpreter untouched
+        Environment environment;
+
+        try {
+            for (const char character : MAGIC) {
+                if (reader.read_u8() != static_cast<std::uint8_t>(character)) {
+                    return false;
+                }
+            }
+
+            if (reader.read_u8() != FORMAT_VERSION) {
+                return false;
+            }
+
+            if (reader.read_u64() != VERSION_MAJOR || reader.read_u64() != VERSION_MINOR || reader.read_u64() != VERSION_PATCH) {
+                return false;
+            }
+
+            ImageReader(&reader, &interpreter).read(environment);
+
+            if (!reader.reached_end()) {
+                return false;
+            }
+        } catch (serialization::Error) {
+            return false;
+        }
+
+        for (const auto& [name, value] : environment.get_values()) {
+            interpreter.get_global_environment().define(name, value);
+        }
+
+        return true;
+    }
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <string>
+
+class Interpreter;
+
+// Heap images: the global environment and every object reachable from it, saved after running a script
+// Loading an image into a fresh interpreter restores that state without executing the script again
+namespace image {
+    bool store(const std::string& image_path, Interpreter& interpreter);
+    bool load(const std::string& image_path, Interpreter& interpreter);
+}
@@ -5,23 +5,51 @@
 #include <unordered_map>
 #include <string>
 #include <cstddef>
+#include <iostream>
 
 #include "runtime_error.hpp"
 #include "builtins.hpp"
 #include "return.hpp"
+#include "stats.hpp"
 
 Interpreter::Interpreter(Context* ctx)
-    : current_environment(&global_environment), ctx(ctx) {
+    : Interpreter(ctx, &std::cout) {}
+
+Interpreter::Interpreter(Context* ctx, std::ostream* output_stream)
+    : Interpreter(ctx, output_stream, &std::cin) {}
+
+Interpreter::Interpreter(Context* ctx, std::ostream* output_stream, std::istream* input_stream)
+    : current_environment(&global_environment), ctx(ctx), output(output_stream), input_stream(input_stream) {
     object::interned::initialize();
 
-    global_environment.define("clock", object::create_builtin_function<builtins::clock>());
-    global_environment.define("print", object::create_builtin_function<builtins::print>());
-    global_environment.define("println", object::create_builtin_function<builtins::println>());
-    global_environment.define("input", object::create_builtin_function<builtins::input>());
-    global_environment.define("str", object::create_builtin_function<builtins::str>());
-    global_environment.define("int", object::create_builtin_function<builtins::int_>());
-    global_environment.define("float", object::create_builtin_function<builtins::float_>());
-    global_environment.define("bool", object::create_builtin_function<builtins::bool_>());
+    for (auto& [name, builtin] : builtins::create_all()) {
+        define_builtin(name, std::move(builtin));
+    }
+}
+
+void Interpreter::reset() {
+    global_environment = Environment();
+
+    for (const auto& [name, builtin] : builtins) {
+        global_environment.define(name, builtin);
+    }
+
+    current_environment = &global_environment;
+}
+
+void Interpreter::define_builtin(const std::string& name, std::shared_ptr<object::Object> builtin) {
+    builtins[name] = builtin;
+    global_environment.define(name, std::move(builtin));
+}
+
+std::shared_ptr<object::Object> Interpreter::get_builtin(const std::string& name) const {
+    const auto iter {builtins.find(name)};
+
+    if (iter == builtins.cend()) {
+        return nullptr;
+    }
+
+    return iter->second;
 }
 
 void Interpreter::interpret(const std::vector<std::shared_ptr<ast::stmt::Stmt<std::shared_ptr<object::Object>>>>& statements) {
@@ -30,8 +58,31 @@ void Interpreter::interpret(const std::vector<std::shared_ptr<ast::stmt::Stmt<st
             execute(statement);
         }
     } catch (const RuntimeError& e) {
+        // Keep the script's output ordered before the error message
+        output.flush();
+
+        ctx->runtime_error(e.token, e.message);
+        return;
+    }
+
+    output.flush();
+}
+
+bool Interpreter::call(const std::shared_ptr<object::Function>& function, const std::vector<std::shared_ptr<object::Object>>& arguments) {
+    try {
+        check_arity(function->name, function, arguments.size());
+
+        profiler::Frame frame {sampler, tracer, function};
+
+        function->call(this, arguments, function->name);
+    } catch (const RuntimeError& e) {
+        output.flush();
+
         ctx->runtime_error(e.token, e.message);
+        return false;
     }
+
+    return true;
 }
 
 std::shared_ptr<object::Object> Interpreter::evaluate(std::shared_ptr<ast::expr::Expr<std::shared_ptr<object::Object>>> expr) {
@@ -309,23 +360,24 @@ std::shared_ptr<object::Object> Interpreter::visit(ast::expr::Call<std::shared_p
 
     std::vector<std::shared_ptr<object::Object>> arguments;
 
-    std::shared_ptr<object::Callable> callable;
+    object::Callable* callable {prepare_call(expr, callee, arguments)};
 
-    switch (callee->type) {
-        case object::Type::BuiltinFunction:
-            callable = object::cast<object::BuiltinFunction>(callee);
-            break;
-        case object::Type::Function:
-            callable = object::cast<object::Function>(callee);
-            break;
-        case object::Type::Method:
-            callable = object::cast<object::Method>(callee);
-            break;
-        case object::Type::Struct:
-            callable = object::cast<object::Struct>(callee);
-            break;
-        default:
-            throw RuntimeError(expr->paren, "Only functions and classes are callable");
+    IL_STATS(if (callee->type == object::Type::BuiltinFunction) stats::counters.builtin_calls++);
+
+    profiler::Frame frame {sampler, tracer, callee};
+
+    return callable->call(this, arguments, expr->paren);
+}
+
+object::Callable* Interpreter::prepare_call(
+    ast::expr::Call<std::shared_ptr<object::Object>>* expr,
+    const std::shared_ptr<object::Object>& callee,
+    std::vector<std::shared_ptr<object::Object>>& arguments
+) {
+    object::Callable* callable {object::as_callable(callee)};
+
+    if (callable == nullptr) {
+        throw RuntimeError(expr->paren, "Only functions and classes are callable");
     }
 
     if (callee->type == object::Type::Method) {
@@ -342,20 +394,36 @@ std::shared_ptr<object::Object> Interpreter::visit(ast::expr::Call<std::shared_p
         arguments.push_back(evaluate(argument));
     }
 
-    const std::size_t arguments_size {
-        callee->type == object::Type::Struct ? arguments.size() + 1u : arguments.size()
-    };
+    check_arity(expr->paren, callee, arguments.size());
 
-    if (arguments_size != callable->arity()) {
-        const char* args {callable->arity() == 1u ? "argument" : "arguments"};
+    return callable;
+}
 
-        throw RuntimeError(
-            expr->paren,
-            "Expected " + std::to_string(callable->arity()) + " " + args + ", but got " + std::to_string(arguments_size)
-        );
+void Interpreter::check_arity(
+    const token::Token& token,
+    const std::shared_ptr<object::Object>& callee,
+    std::size_t arguments_size
+) {
+    const object::Callable* callable {object::as_callable(callee)};
+
+    // The instance is passed to the initializer too
+    if (callee->type == object::Type::Struct) {
+        arguments_size++;
     }
 
-    return callable->call(this, arguments, expr->paren);
+    const bool variadic {callable->variadic()};
+
+    if (variadic ? arguments_size >= callable->arity() : arguments_size == callable->arity()) {
+        return;
+    }
+
+    const char* args {callable->arity() == 1u ? "argument" : "arguments"};
+
+    throw RuntimeError(
+        token,
+        std::string(variadic ? "Expected at least " : "Expected ") + std::to_string(callable->arity()) + " " + args
+            + ", but got " + std::to_string(arguments_size)
+    );
 }
 
 std::shared_ptr<object::Object> Interpreter::visit(ast::expr::Get<std::shared_ptr<object::Object>>* expr) {
@@ -382,7 +450,152 @@ std::shared_ptr<object::Object> Interpreter::visit(ast::expr::Set<std::shared_pt
     return value;
 }
 
+std::shared_ptr<object::Object> Interpreter::visit(ast::expr::Array<std::shared_ptr<object::Object>>* expr) {
+    std::vector<std::shared_ptr<object::Object>> elements;
+    elements.reserve(expr->elements.size());
+
+    for (const auto& element : expr->elements) {
+        elements.push_back(evaluate(element));
+    }
+
+    return object::create_array(std::move(elements));
+}
+
+std::shared_ptr<object::Object> Interpreter::visit(ast::expr::Index<std::shared_ptr<object::Object>>* expr) {
+    std::shared_ptr<object::Object> object {evaluate(expr->object)};
+
+    if (object->type == object::Type::Map) {
+        std::shared_ptr<object::Object> key {evaluate(expr->index)};
+        std::shared_ptr<object::Object>* value {
+            object::cast<object::Map>(object)->entries.find(*key, hash_key(expr->bracket, key))
+        };
+
+        if (value == nullptr) {
+            throw RuntimeError(expr->bracket, "Key " + key->to_string() + " not found");
+        }
+
+        return *value;
+    }
+
+    if (object->type == object::Type::IntArray) {
+        const auto& values {object::cast<object::IntArray>(object)->values};
+
+        return object::create_integer(values[check_index(expr->bracket, evaluate(expr->index), values.size())]);
+    }
+
+    if (object->type == object::Type::FloatArray) {
+        const auto& values {object::cast<object::FloatArray>(object)->values};
+
+        return object::create_float(values[check_index(expr->bracket, evaluate(expr->index), values.size())]);
+    }
+
+    if (object->type != object::Type::Array) {
+        throw RuntimeError(expr->bracket, "Only arrays and maps can be indexed");
+    }
+
+    auto array {object::cast<object::Array>(object)};
+
+    return array->elements[check_index(expr->bracket, evaluate(expr->index), array->elements.size())];
+}
+
+std::shared_ptr<object::Object> Interpreter::visit(ast::expr::IndexSet<std::shared_ptr<object::Object>>* expr) {
+    std::shared_ptr<object::Object> object {evaluate(expr->object)};
+
+    if (object->type == object::Type::Map) {
+        std::shared_ptr<object::Object> key {evaluate(expr->index)};
+        const std::size_t hash {hash_key(expr->bracket, key)};
+
+        std::shared_ptr<object::Object> value {evaluate(expr->value)};
+
+        object::cast<object::Map>(object)->entries.insert(key, hash, value);
+
+        return value;
+    }
+
+    if (object->type == object::Type::IntArray || object->type == object::Type::FloatArray) {
+        return set_number(expr, object);
+    }
+
+    if (object->type != object::Type::Array) {
+        throw RuntimeError(expr->bracket, "Only arrays and maps can be indexed");
+    }
+
+    auto array {object::cast<object::Array>(object)};
+
+    const std::size_t index {check_index(expr->bracket, evaluate(expr->index), array->elements.size())};
+
+    std::shared_ptr<object::Object> value {evaluate(expr->value)};
+
+    // The value's evaluation might have resized the array
+    if (index >= array->elements.size()) {
+        throw RuntimeError(expr->bracket, "Index out of range");
+    }
+
+    array->elements[index] = value;
+
+    return value;
+}
+
+std::shared_ptr<object::Object> Interpreter::set_number(
+    ast::expr::IndexSet<std::shared_ptr<object::Object>>* expr,
+    const std::shared_ptr<object::Object>& object
+) {
+    std::shared_ptr<object::Object> index {evaluate(expr->index)};
+    std::shared_ptr<object::Object> value {evaluate(expr->value)};
+
+    if (object->type == object::Type::IntArray) {
+        if (value->type != object::Type::Integer) {
+            throw RuntimeError(expr->bracket, "Elements of int arrays must be integers");
+        }
+
+        auto& values {object::cast<object::IntArray>(object)->values};
+        values[check_index(expr->bracket, index, values.size())] = object::cast<object::Integer>(value)->value;
+    } else {
+        double number {};
+
+        if (!numeric_value(value, number)) {
+            throw RuntimeError(expr->bracket, "Elements of float arrays must be numbers");
+        }
+
+        auto& values {object::cast<object::FloatArray>(object)->values};
+        values[check_index(expr->bracket, index, values.size())] = number;
+    }
+
+    return value;
+}
+
+std::shared_ptr<object::Object> Interpreter::visit(ast::expr::MapLiteral<std::shared_ptr<object::Object>>* expr) {
+    std::shared_ptr<object::Object> map {object::create_map()};
+    table::Table& entries {object::cast<object::Map>(map)->entries};
+
+    for (std::size_t i {0u}; i < expr->keys.size(); i++) {
+        std::shared_ptr<object::Object> key {evaluate(expr->keys[i])};
+        const std::size_t hash {hash_key(expr->brace, key)};
+
+        entries.insert(key, hash, evaluate(expr->values[i]));
+    }
+
+    return map;
+}
+
+std::shared_ptr<object::Object> Interpreter::visit(ast::expr::SetLiteral<std::shared_ptr<object::Object>>* expr) {
+    std::shared_ptr<object::Object> set {object::create_set()};
+    table::Table& elements {object::cast<object::Set>(set)->elements};
+
+    for (const auto& element : expr->elements) {
+        std::shared_ptr<object::Object> key {evaluate(element)};
+
+        elements.insert(key, hash_key(expr->brace, key), nullptr);
+    }
+
+    return set;
+}
+
 void Interpreter::execute(std::shared_ptr<ast::stmt::Stmt<std::shared_ptr<object::Object>>> stmt) {
+    if (sampler != nullptr && stmt->line != 0u) {
+        sampler->set_line(stmt->line);
+    }
+
     stmt->accept(this);
 }
 
@@ -396,17 +609,16 @@ void Interpreter::execute(const std::vector<std::shared_ptr<ast::stmt::Stmt<std:
 
         for (const auto& statement : stmts) {
             execute(statement);
+
+            if (returning) {
+                break;
+            }
         }
     } catch (const RuntimeError&) {
         current_environment = previous_environment;
 
         // Don't handle error here
         throw;
-    } catch (const Return&) {
-        current_environment = previous_environment;
-
-        // Don't handle return here
-        throw;
     }
 
     current_environment = previous_environment;
@@ -433,7 +645,7 @@ std::shared_ptr<object::Object> Interpreter::visit(const ast::stmt::Let<std::sha
 }
 
 std::shared_ptr<object::Object> Interpreter::visit(const ast::stmt::Function<std::shared_ptr<object::Object>>* stmt) {
-    std::shared_ptr<object::Object> function {object::create_function(stmt->name, stmt->parameters, stmt->body)};
+    std::shared_ptr<object::Object> function {object::create_function(stmt->name, stmt->parameters, stmt->body, stmt->memoized, stmt->lazy)};
 
     current_environment->define(stmt->name.get_lexeme(), function);
 
@@ -452,7 +664,8 @@ std::shared_ptr<object::Object> Interpreter::visit(const ast::stmt::Struct<std::
             object::create_method(
                 method->name,
                 method->parameters,
-                method->body
+                method->body,
+                method->lazy
             )
         );
     }
@@ -493,8 +706,73 @@ std::shared_ptr<object::Object> Interpreter::visit(const ast::stmt::While<std::s
         }
 
         execute(stmt->body);
+
+        if (returning) {
+            break;
+        }
+    }
+
+    return nullptr;
+}
+
+std::shared_ptr<object::Object> Interpreter::visit(const ast::stmt::ForRange<std::shared_ptr<object::Object>>* stmt) {
+    const long long start {stmt->start != nullptr ? range_bound(stmt->range, evaluate(stmt->start)) : 0ll};
+    const long long stop {range_bound(stmt->range, evaluate(stmt->stop))};
+    const long long step {stmt->step != nullptr ? range_bound(stmt->range, evaluate(stmt->step)) : 1ll};
+
+    if (step == 0ll) {
+        throw RuntimeError(stmt->range, "range() step must not be zero");
+    }
+
+    // Count the iterations up front in unsigned arithmetic, so that the counter never overflows
+    unsigned long long iterations {0u};
+
+    if (step > 0ll && start < stop) {
+        iterations = (static_cast<unsigned long long>(stop) - static_cast<unsigned long long>(start) - 1u)
+            / static_cast<unsigned long long>(step) + 1u;
+    } else if (step < 0ll && start > stop) {
+        iterations = (static_cast<unsigned long long>(start) - static_cast<unsigned long long>(stop) - 1u)
+            / (0u - static_cast<unsigned long long>(step)) + 1u;
+    }
+
+    Environment* previous_environment {current_environment};
+
+    try {
+        Environment loop_environment {current_environment};
+        current_environment = &loop_environment;
+
+        loop_environment.define(stmt->name.get_lexeme(), nullptr);
+        std::shared_ptr<object::Object>& variable {loop_environment.slot(stmt->name.get_lexeme())};
+
+        unsigned long long counter {static_cast<unsigned long long>(start)};
+
+        for (unsigned long long i {0u}; i < iterations; i++) {
+            const long long value {static_cast<long long>(counter)};
+
+            // Reuse the previous integer when nothing else kept a reference to it, otherwise it must stay unchanged
+            if (variable != nullptr && variable->type == object::Type::Integer && variable.use_count() == 1l) {
+                object::cast<object::Integer>(variable)->value = value;
+            } else {
+                variable = object::create_integer(value);
+            }
+
+            execute(stmt->body);
+
+            if (returning) {
+                break;
+            }
+
+            counter += static_cast<unsigned long long>(step);
+        }
+    } catch (const RuntimeError&) {
+        current_environment = previous_environment;
+
+        // Don't handle error here
+        throw;
     }
 
+    current_environment = previous_environment;
+
     return nullptr;
 }
 
@@ -505,6 +783,24 @@ std::shared_ptr<object::Object> Interpreter::visit(const ast::stmt::Block<std::s
 }
 
 std::shared_ptr<object::Object> Interpreter::visit(const ast::stmt::Return<std::shared_ptr<object::Object>>* stmt) {
+    if (stmt->tail_call != nullptr) {
+        // Let the function unwind its frame first and then make the call in its place
+        std::shared_ptr<object::Object> callee {evaluate(stmt->tail_call->callee)};
+
+        std::vector<std::shared_ptr<object::Object>> arguments;
+
+        prepare_call(stmt->tail_call.get(), callee, arguments);
+
+        IL_STATS(stats::counters.returns++);
+
+        return_value.callee = std::move(callee);
+        return_value.arguments = std::move(arguments);
+        return_value.token = &stmt->tail_call->paren;
+        returning = true;
+
+        return nullptr;
+    }
+
     std::shared_ptr<object::Object> value {
         stmt->value != nullptr
         ?
@@ -513,7 +809,12 @@ std::shared_ptr<object::Object> Interpreter::visit(const ast::stmt::Return<std::
         object::create_none()
     };
 
-    throw Return(value);  // Not great
+    IL_STATS(stats::counters.returns++);
+
+    return_value.value = std::move(value);
+    returning = true;
+
+    return nullptr;
 }
 
 void Interpreter::check_boolean_operand(const token::Token& token, const std::shared_ptr<object::Object>& right) {
@@ -531,3 +832,48 @@ void Interpreter::check_boolean_value(const token::Token& token, const std::shar
 
     throw RuntimeError(token, "Value must be a boolean expression");
 }
+
+std::size_t Interpreter::check_index(const token::Token& token, const std::shared_ptr<object::Object>& index, std::size_t size) {
+    if (index->type != object::Type::Integer) {
+        throw RuntimeError(token, "Index must be an integer");
+    }
+
+    const long long value {object::cast<object::Integer>(index)->value};
+
+    if (value < 0ll || static_cast<unsigned long long>(value) >= size) {
+        throw RuntimeError(token, "Index " + std::to_string(value) + " out of range for length " + std::to_string(size));
+    }
+
+    return static_cast<std::size_t>(value);
+}
+
+long long Interpreter::range_bound(const token::Token& token, const std::shared_ptr<object::Object>& bound) {
+    if (bound->type != object::Type::Integer) {
+        throw RuntimeError(token, "range() arguments must be integers");
+    }
+
+    return object::cast<object::Integer>(bound)->value;
+}
+
+bool Interpreter::numeric_value(const std::shared_ptr<object::Object>& object, double& result) {
+    switch (object->type) {
+        case object::Type::Integer:
+            result = static_cast<double>(object::cast<object::Integer>(object)->value);
+            return true;
+        case object::Type::Float:
+            result = object::cast<object::Float>(object)->value;
+            return true;
+        default:
+            return false;
+    }
+}
+
+std::size_t Interpreter::hash_key(const token::Token& token, const std::shared_ptr<object::Object>& key) {
+    std::size_t hash {};
+
+    if (!table::hash(*key, hash)) {
+        throw RuntimeError(token, "Keys must be none, integers, floats, strings or booleans");
+    }
+
+    return hash;
+}
@@ -2,20 +2,57 @@
 
 #include <vector>
 #include <memory>
+#include <string>
+#include <unordered_map>
+#include <ostream>
+#include <istream>
 
 #include "ast.hpp"
 #include "object.hpp"
 #include "token.hpp"
 #include "context.hpp"
 #include "environment.hpp"
+#include "output.hpp"
+#include "profiler.hpp"
+#include "return.hpp"
 
 class Interpreter : ast::expr::Visitor<std::shared_ptr<object::Object>>, ast::stmt::Visitor<std::shared_ptr<object::Object>> {
 public:
     Interpreter(Context* ctx);
+    Interpreter(Context* ctx, std::ostream* output_stream);
+    Interpreter(Context* ctx, std::ostream* output_stream, std::istream* input_stream);
 
     void interpret(const std::vector<std::shared_ptr<ast::stmt::Stmt<std::shared_ptr<object::Object>>>>& statements);
 
+    // Calls a function of the script from the host, reporting runtime errors as interpret does; false after an error
+    // The output is not flushed, so that calling many times stays cheap
+    bool call(const std::shared_ptr<object::Function>& function, const std::vector<std::shared_ptr<object::Object>>& arguments);
+
+    // Drops every global variable, leaving only the builtins, as in a new interpreter
+    void reset();
+
+    // Builtins stay defined across resets; embedders add their host functions and values this way
+    void define_builtin(const std::string& name, std::shared_ptr<object::Object> builtin);
+
     Context* get_ctx() const { return ctx; }
+    Output& get_output() { return output; }
+    std::istream& get_input() { return *input_stream; }
+    const std::vector<std::string>& get_arguments() const { return arguments; }
+    void set_arguments(const std::vector<std::string>& arguments) { this->arguments = arguments; }
+    Environment& get_global_environment() { return global_environment; }
+    std::shared_ptr<object::Object> get_builtin(const std::string& name) const;
+    const std::unordered_map<std::string, std::shared_ptr<object::Object>>& get_builtins() const { return builtins; }
+    void set_sampler(profiler::Sampler* sampler) { this->sampler = sampler; }
+    void set_tracer(profiler::Tracer* tracer) { this->tracer = tracer; }
+
+    // Map and set keys must be hashable
+    static std::size_t hash_key(const token::Token& token, const std::shared_ptr<object::Object>& key);
+
+    // Integers are converted to floats; false for anything else
+    static bool numeric_value(const std::shared_ptr<object::Object>& object, double& result);
+
+    // The callee must be callable; methods' arguments include their instance
+    static void check_arity(const token::Token& token, const std::shared_ptr<object::Object>& callee, std::size_t arguments_size);
 private:
     std::shared_ptr<object::Object> evaluate(std::shared_ptr<ast::expr::Expr<std::shared_ptr<object::Object>>> expr);
 
@@ -29,6 +66,22 @@ private:
     std::shared_ptr<object::Object> visit(ast::expr::Call<std::shared_ptr<object::Object>>* expr) override;
     std::shared_ptr<object::Object> visit(ast::expr::Get<std::shared_ptr<object::Object>>* expr) override;
     std::shared_ptr<object::Object> visit(ast::expr::Set<std::shared_ptr<object::Object>>* expr) override;
+    std::shared_ptr<object::Object> visit(ast::expr::Array<std::shared_ptr<object::Object>>* expr) override;
+    std::shared_ptr<object::Object> visit(ast::expr::Index<std::shared_ptr<object::Object>>* expr) override;
+    std::shared_ptr<object::Object> visit(ast::expr::IndexSet<std::shared_ptr<object::Object>>* expr) override;
+    std::shared_ptr<object::Object> visit(ast::expr::MapLiteral<std::shared_ptr<object::Object>>* expr) override;
+    std::shared_ptr<object::Object> visit(ast::expr::SetLiteral<std::shared_ptr<object::Object>>* expr) override;
+
+    std::shared_ptr<object::Object> set_number(
+        ast::expr::IndexSet<std::shared_ptr<object::Object>>* expr,
+        const std::shared_ptr<object::Object>& object
+    );
+
+    object::Callable* prepare_call(
+        ast::expr::Call<std::shared_ptr<object::Object>>* expr,
+        const std::shared_ptr<object::Object>& callee,
+        std::vector<std::shared_ptr<object::Object>>& arguments
+    );
 
     void execute(std::shared_ptr<ast::stmt::Stmt<std::shared_ptr<object::Object>>> stmt);
     void execute(const std::vector<std::shared_ptr<ast::stmt::Stmt<std::shared_ptr<object::Object>>>>& stmts, Environment&& environment);
@@ -39,15 +92,29 @@ private:
     std::shared_ptr<object::Object> visit(const ast::stmt::Struct<std::shared_ptr<object::Object>>* stmt) override;
     std::shared_ptr<object::Object> visit(const ast::stmt::If<std::shared_ptr<object::Object>>* stmt) override;
     std::shared_ptr<object::Object> visit(const ast::stmt::While<std::shared_ptr<object::Object>>* stmt) override;
+    std::shared_ptr<object::Object> visit(const ast::stmt::ForRange<std::shared_ptr<object::Object>>* stmt) override;
     std::shared_ptr<object::Object> visit(const ast::stmt::Block<std::shared_ptr<object::Object>>* stmt) override;
     std::shared_ptr<object::Object> visit(const ast::stmt::Return<std::shared_ptr<object::Object>>* stmt) override;
 
     static void check_boolean_operand(const token::Token& token, const std::shared_ptr<object::Object>& right);
     static void check_boolean_value(const token::Token& token, const std::shared_ptr<object::Object>& value);
+    static long long range_bound(const token::Token& token, const std::shared_ptr<object::Object>& bound);
+    static std::size_t check_index(const token::Token& token, const std::shared_ptr<object::Object>& index, std::size_t size);
 
     Environment global_environment;
     Environment* current_environment {nullptr};
+    std::unordered_map<std::string, std::shared_ptr<object::Object>> builtins;
     Context* ctx {nullptr};
+    Output output;
+    std::istream* input_stream {nullptr};
+    std::vector<std::string> arguments;  // Of the script, from the command line
+    profiler::Sampler* sampler {nullptr};
+    profiler::Tracer* tracer {nullptr};
+
+    // Set by return statements, unwinding the statements up to the function call
+    bool returning {false};
+    Return return_value;
 
     friend struct object::Function;
+    friend struct object::Struct;
 };
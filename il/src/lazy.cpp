@@ -0,0 +1,76 @@
+#include "lazy.hpp"
+
+#include <sstream>
+#include <utility>
+
+#include "parser.hpp"
+#include "analyzer.hpp"
+#include "context.hpp"
+#include "runtime_error.hpp"
+
+namespace lazy {
+    Body::Body(
+        std::shared_ptr<const std::vector<token::Token>> tokens,
+        std::size_t begin,
+        std::size_t end,
+        const token::Token& name,
+        bool memoized
+    )
+        : tokens(std::move(tokens)), begin(begin), end(end), name(name), memoized(memoized) {}
+
+    const Statements& Body::get() {
+        if (!compiled.load(std::memory_order_acquire)) {
+            std::lock_guard<std::mutex> lock {mutex};
+
+            if (!compiled.load(std::memory_order_relaxed)) {
+                compile();
+                compiled.store(true, std::memory_order_release);
+            }
+        }
+
+        if (!errors.empty()) {
+            throw RuntimeError(name, "Function `" + name.get_lexeme() + "` does not compile\n" + errors);
+        }
+
+        return statements;
+    }
+
+    void Body::compile() {
+        // Parsed on its own, so that errors can't run past the closing brace
+        std::vector<token::Token> body_tokens {tokens->cbegin() + begin, tokens->cbegin() + end + 1u};
+        body_tokens.emplace_back(token::TokenType::Eof, "", (*tokens)[end].get_line());
+
+        tokens.reset();
+
+        std::ostringstream stream;
+        Context ctx {&stream};
+
+        Parser parser {body_tokens, &ctx};
+        statements = parser.parse_body<std::shared_ptr<object::Object>>();
+
+        // The same checks as for the function declared in place
+        if (stream.str().empty()) {
+            const Statements function {
+                std::make_shared<ast::stmt::Function<std::shared_ptr<object::Object>>>(name, std::vector<token::Token>(), statements, memoized)
+            };
+
+            Analyzer analyzer {&ctx};
+            analyzer.analyze(function);
+        }
+
+        errors = stream.str();
+
+        if (!errors.empty()) {
+            errors.pop_back();  // The last newline
+            statements.clear();
+        }
+    }
+
+    const Statements& body(const ast::stmt::Function<std::shared_ptr<object::Object>>& function) {
+        return function.lazy != nullptr ? function.lazy->get() : function.body;
+    }
+
+    const Statements& body(const object::Function& function) {
+        return function.lazy != nullptr ? function.lazy->get() : function.body;
+    }
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <string>
+#include <cstddef>
+
+#include "ast.hpp"
+#include "object.hpp"
+#include "token.hpp"
+
+// Function bodies whose braces are only matched when the program is compiled; they are parsed and analyzed on the
+// first call, so that programs calling few of their functions start faster
+namespace lazy {
+    using Statements = std::vector<std::shared_ptr<ast::stmt::Stmt<std::shared_ptr<object::Object>>>>;
+
+    class Body {
+    public:
+        // The tokens from after the opening brace of the body up to its closing brace
+        Body(
+            std::shared_ptr<const std::vector<token::Token>> tokens,
+            std::size_t begin,
+            std::size_t end,
+            const token::Token& name,
+            bool memoized
+        );
+
+        // Compiles the body the first time, on any thread; throws RuntimeError if it doesn't compile
+        const Statements& get();
+    private:
+        void compile();
+
+        std::shared_ptr<const std::vector<token::Token>> tokens;  // Released once compiled
+        std::size_t begin {};
+        std::size_t end {};
+        token::Token name;
+        bool memoized {false};
+
+        std::atomic<bool> compiled {false};
+        std::mutex mutex;
+        Statements statements;
+        std::string errors;  // Empty if it compiled
+    };
+
+    // The body of either kind of function, compiling it if it's lazy
+    const Statements& body(const ast::stmt::Function<std::shared_ptr<object::Object>>& function);
+    const Statements& body(const object::Function& function);
+}
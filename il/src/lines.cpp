@@ -0,0 +1,65 @@
+#include "lines.hpp"
+
+#include <cstring>
+
+LineReader::LineReader(std::istream* stream, std::size_t capacity)
+    : buffer(std::make_unique<char[]>(capacity)), capacity(capacity), stream(stream) {}
+
+bool LineReader::next(std::string& line) {
+    std::size_t searched {begin};  // Everything before has no newline
+
+    while (true) {
+        const void* newline {std::memchr(buffer.get() + searched, '\n', end - searched)};
+
+        if (newline != nullptr) {
+            const std::size_t position {static_cast<std::size_t>(static_cast<const char*>(newline) - buffer.get())};
+
+            line.assign(buffer.get() + begin, position - begin);
+            begin = position + 1u;
+
+            return true;
+        }
+
+        if (exhausted) {
+            if (begin == end) {
+                return false;
+            }
+
+            line.assign(buffer.get() + begin, end - begin);
+            begin = end;
+
+            return true;
+        }
+
+        // The unfinished line is moved to the front by filling
+        searched = end - begin;
+        fill();
+    }
+}
+
+void LineReader::fill() {
+    if (begin > 0u) {
+        std::memmove(buffer.get(), buffer.get() + begin, end - begin);
+        end -= begin;
+        begin = 0u;
+    }
+
+    if (end == capacity) {
+        std::unique_ptr<char[]> larger {std::make_unique<char[]>(capacity * 2u)};
+        std::memcpy(larger.get(), buffer.get(), end);
+
+        buffer = std::move(larger);
+        capacity *= 2u;
+    }
+
+    // Straight from the stream buffer, skipping the formatting machinery of the stream
+    const std::streamsize count {
+        stream->rdbuf()->sgetn(buffer.get() + end, static_cast<std::streamsize>(capacity - end))
+    };
+
+    if (count <= 0) {
+        exhausted = true;
+    } else {
+        end += static_cast<std::size_t>(count);
+    }
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <istream>
+#include <string>
+#include <cstddef>
+#include <memory>
+
+// Splits a stream into lines, reading it in large blocks rather than one line at a time
+class LineReader {
+public:
+    static constexpr std::size_t DEFAULT_CAPACITY {1048576u};
+
+    explicit LineReader(std::istream* stream, std::size_t capacity = DEFAULT_CAPACITY);
+
+    LineReader(const LineReader&) = delete;
+    LineReader& operator=(const LineReader&) = delete;
+
+    // Lines don't include the newline; the last one doesn't need to end with one
+    // False at the end of the stream
+    bool next(std::string& line);
+private:
+    void fill();
+
+    std::unique_ptr<char[]> buffer;
+    std::size_t capacity {};  // Grows for lines that don't fit
+    std::size_t begin {};  // Start of the next line
+    std::size_t end {};  // End of the data read so far
+    bool exhausted {false};
+
+    std::istream* stream {nullptr};
+};
@@ -1,12 +1,262 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstddef>
+#include <thread>
+#include <algorithm>
+
 #include "il.hpp"
+#include "batch.hpp"
+#include "bench.hpp"
+#include "server.hpp"
+#include "numeric.hpp"
+#include "stats.hpp"
+
+struct Arguments {
+    std::size_t buffer_size {};
+    bool use_cache {false};
+    bool lazy {false};
+    std::string image_path;
+    std::string snapshot_path;
+    bool profile {false};
+    std::string profile_folded_path;
+    bool stats {false};
+    std::string callgraph_path;
+    std::string callgraph_folded_path;
+
+    bool lines {false};
+
+    bool bench {false};
+    bench::Options bench_options;
+
+    bool batch {false};
+    batch::Options batch_options;
+
+    bool serve {false};
+    server::Options server_options;
+
+    std::vector<std::string> files;
+    std::vector<std::string> script_arguments;
+};
+
+static int usage() {
+    std::cerr <<
+        "usage: il [--buffer-size <bytes>] [--cache] [--lazy] [--image <path>] [--snapshot <path>]\n"
+        "          [--profile] [--profile-folded <path>] [--callgraph <path>] [--callgraph-folded <path>]\n"
+        "          [--stats] [file [argument...]]\n"
+        "       il -n [options] file [input]\n"
+        "       il --bench [--runs <n>] [--warmup <n>] [--json] [--cache] [--image <path>] file...\n"
+        "       il --jobs <n> [--manifest <path>] [--cache] [--image <path>] [file...]\n"
+        "       il --serve <socket> [--workers <n>] [--cache] [--image <path>]\n";
+
+    return 1;
+}
+
+static bool parse_count(const char* string, long long minimum, long long& result) {
+    if (numeric::parse(string, result) != numeric::Error::None || result < minimum) {
+        std::cerr << "il: invalid number `" << string << "`\n";
+        return false;
+    }
+
+    return true;
+}
+
+static bool parse_arguments(int argc, char** argv, Arguments& arguments) {
+    int i {1};
+
+    for (; i < argc && argv[i][0u] == '-'; i++) {
+        const bool has_value {i + 1 < argc};
+        long long value {};
+
+        if (std::strcmp(argv[i], "--buffer-size") == 0 && has_value) {
+            if (!parse_count(argv[++i], 1ll, value)) {
+                return false;
+            }
+
+            arguments.buffer_size = static_cast<std::size_t>(value);
+        } else if (std::strcmp(argv[i], "--cache") == 0) {
+            arguments.use_cache = true;
+        } else if (std::strcmp(argv[i], "--lazy") == 0) {
+            arguments.lazy = true;
+        } else if (std::strcmp(argv[i], "--image") == 0 && has_value) {
+            arguments.image_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--snapshot") == 0 && has_value) {
+            arguments.snapshot_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--profile") == 0) {
+            arguments.profile = true;
+        } else if (std::strcmp(argv[i], "--profile-folded") == 0 && has_value) {
+            arguments.profile_folded_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--callgraph") == 0 && has_value) {
+            arguments.callgraph_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--callgraph-folded") == 0 && has_value) {
+            arguments.callgraph_folded_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--stats") == 0) {
+            arguments.stats = true;
+        } else if (std::strcmp(argv[i], "-n") == 0) {
+            arguments.lines = true;
+        } else if (std::strcmp(argv[i], "--bench") == 0) {
+            arguments.bench = true;
+        } else if (std::strcmp(argv[i], "--runs") == 0 && has_value) {
+            if (!parse_count(argv[++i], 1ll, value)) {
+                return false;
+            }
+
+            arguments.bench_options.runs = static_cast<unsigned int>(value);
+        } else if (std::strcmp(argv[i], "--warmup") == 0 && has_value) {
+            if (!parse_count(argv[++i], 0ll, value)) {
+                return false;
+            }
+
+            arguments.bench_options.warmup = static_cast<unsigned int>(value);
+        } else if (std::strcmp(argv[i], "--json") == 0) {
+            arguments.bench_options.json = true;
+        } else if (std::strcmp(argv[i], "--jobs") == 0 && has_value) {
+            if (!parse_count(argv[++i], 1ll, value)) {
+                return false;
+            }
+
+            arguments.batch = true;
+            arguments.batch_options.jobs = static_cast<unsigned int>(value);
+        } else if (std::strcmp(argv[i], "--manifest") == 0 && has_value) {
+            arguments.batch = true;
+            arguments.batch_options.manifest_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--serve") == 0 && has_value) {
+            arguments.serve = true;
+            arguments.server_options.socket_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--workers") == 0 && has_value) {
+            if (!parse_count(argv[++i], 1ll, value)) {
+                return false;
+            }
+
+            arguments.server_options.workers = static_cast<unsigned int>(value);
+        } else {
+            return false;
+        }
+    }
+
+    for (; i < argc; i++) {
+        arguments.files.push_back(argv[i]);
+
+        if (!arguments.bench && !arguments.batch && !(arguments.lines && arguments.files.size() < 2u)) {
+            break;
+        }
+    }
+
+    // The rest is for the script
+    for (i++; i < argc; i++) {
+        arguments.script_arguments.push_back(argv[i]);
+    }
+
+    const int modes {
+        static_cast<int>(arguments.bench) + static_cast<int>(arguments.batch) + static_cast<int>(arguments.lines)
+            + static_cast<int>(arguments.serve)
+    };
+
+    if (modes > 1) {
+        return false;
+    }
+
+    return !(arguments.serve && !arguments.files.empty())
+        && !(arguments.lines && arguments.files.empty())
+        && !(arguments.bench && arguments.files.empty())
+        && !(arguments.batch && arguments.files.empty() && arguments.batch_options.manifest_path.empty());
+}
+
+static void configure(Il& interpreter, const Arguments& arguments) {
+    if (arguments.buffer_size > 0u) {
+        interpreter.set_output_buffer_size(arguments.buffer_size);
+    }
+
+    interpreter.set_use_cache(arguments.use_cache);
+    interpreter.set_lazy(arguments.lazy);
+    interpreter.set_image_path(arguments.image_path);
+    interpreter.set_snapshot_path(arguments.snapshot_path);
+    interpreter.set_profile(arguments.profile);
+    interpreter.set_profile_folded_path(arguments.profile_folded_path);
+    interpreter.set_stats(arguments.stats);
+    interpreter.set_callgraph_path(arguments.callgraph_path);
+    interpreter.set_callgraph_folded_path(arguments.callgraph_folded_path);
+    interpreter.set_arguments(arguments.script_arguments);
+}
+
+// The script, then the input, which is stdin if not given
+static int run_lines(Il& interpreter, const std::vector<std::string>& files) {
+    const std::shared_ptr<const Program> program {interpreter.compile_file(files.front())};
+
+    if (program == nullptr) {
+        return 1;
+    }
+
+    if (files.size() < 2u) {
+        return interpreter.run_lines(*program, std::cin);
+    }
+
+    std::ifstream stream {files[1u], std::ios_base::binary};
+
+    if (!stream.is_open()) {
+        std::cerr << "il: could not read file `" << files[1u] << "`\n";
+        return 1;
+    }
+
+    return interpreter.run_lines(*program, stream);
+}
 
 int main(int argc, char** argv) {
+    Arguments arguments;
+
+    if (!parse_arguments(argc, argv, arguments)) {
+        return usage();
+    }
+
+    if (arguments.stats && !stats::ENABLED) {
+        std::cerr << "il: runtime statistics are not compiled in; configure with -DIL_ENABLE_STATS=ON\n";
+        arguments.stats = false;
+    }
+
+    // The sampling profiler owns a process-wide timer, so only one script at a time could be profiled
+    if (arguments.batch && arguments.profile) {
+        std::cerr << "il: --profile can't be used with --jobs\n";
+        return 1;
+    }
+
+    if (arguments.serve && arguments.profile) {
+        std::cerr << "il: --profile can't be used with --serve\n";
+        return 1;
+    }
+
+    if (arguments.serve) {
+        return server::run(arguments.server_options, [&arguments](Il& interpreter) {
+            configure(interpreter, arguments);
+        });
+    }
+
+    if (arguments.batch) {
+        return batch::run(arguments.batch_options, arguments.files, [&arguments](Il& interpreter) {
+            configure(interpreter, arguments);
+        });
+    }
+
+    if (arguments.bench) {
+        return bench::run(arguments.bench_options, arguments.files, [&arguments](Il& interpreter) {
+            configure(interpreter, arguments);
+        });
+    }
+
     Il interpreter;
+    configure(interpreter, arguments);
+
+    // Batches and servers already keep every core busy with separate scripts
+    interpreter.set_front_end_jobs(std::max(std::thread::hardware_concurrency(), 1u));
+
+    if (arguments.lines) {
+        return run_lines(interpreter, arguments.files);
+    }
 
-    if (argc == 1) {
+    if (arguments.files.empty()) {
         return interpreter.run_repl();
     } else {
-        // TODO the other arguments should be picked up by the script
-        return interpreter.run_file(argv[1u]);
+        return interpreter.run_file(arguments.files.front());
     }
 }
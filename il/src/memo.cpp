@@ -0,0 +1,102 @@
+#include "memo.hpp"
+
+#include <functional>
+#include <cstring>
+#include <cstdint>
+
+#include "table.hpp"
+
+namespace memo {
+    using table::mix;
+
+    // Floats are compared bitwise, so that zeros of different signs and NaNs are keys like any other
+    static std::uint64_t bits(double value) {
+        std::uint64_t result {};
+        std::memcpy(&result, &value, sizeof(result));
+
+        return result;
+    }
+
+    bool Table::hash(const std::vector<std::shared_ptr<object::Object>>& arguments, std::size_t& result) {
+        std::size_t hash {arguments.size()};
+
+        for (const auto& argument : arguments) {
+            hash = mix(hash, static_cast<std::uint64_t>(argument->type));
+
+            switch (argument->type) {
+                case object::Type::None:
+                    break;
+                case object::Type::Integer:
+                    hash = mix(hash, static_cast<std::uint64_t>(object::cast<object::Integer>(argument)->value));
+                    break;
+                case object::Type::Float:
+                    hash = mix(hash, bits(object::cast<object::Float>(argument)->value));
+                    break;
+                case object::Type::String:
+                    hash = mix(hash, std::hash<std::string>()(object::cast<object::String>(argument)->value));
+                    break;
+                case object::Type::Boolean:
+                    hash = mix(hash, object::cast<object::Boolean>(argument)->value ? 1u : 0u);
+                    break;
+                default:
+                    return false;
+            }
+        }
+
+        result = hash;
+
+        return true;
+    }
+
+    std::shared_ptr<object::Object> Table::find(const std::vector<std::shared_ptr<object::Object>>& arguments, std::size_t hash) const {
+        if (entries.empty()) {
+            return nullptr;
+        }
+
+        const Entry& entry {entries[hash & (CAPACITY - 1u)]};
+
+        if (entry.result == nullptr || entry.hash != hash || entry.arguments.size() != arguments.size()) {
+            return nullptr;
+        }
+
+        for (std::size_t i {0u}; i < arguments.size(); i++) {
+            if (!equal(*entry.arguments[i], *arguments[i])) {
+                return nullptr;
+            }
+        }
+
+        return entry.result;
+    }
+
+    void Table::insert(const std::vector<std::shared_ptr<object::Object>>& arguments, std::size_t hash, std::shared_ptr<object::Object> result) {
+        if (entries.empty()) {
+            entries.resize(CAPACITY);
+        }
+
+        Entry& entry {entries[hash & (CAPACITY - 1u)]};
+        entry.hash = hash;
+        entry.arguments = arguments;
+        entry.result = result;
+    }
+
+    bool Table::equal(const object::Object& left, const object::Object& right) {
+        if (left.type != right.type) {
+            return false;
+        }
+
+        switch (left.type) {
+            case object::Type::None:
+                return true;
+            case object::Type::Integer:
+                return static_cast<const object::Integer&>(left).value == static_cast<const object::Integer&>(right).value;
+            case object::Type::Float:
+                return bits(static_cast<const object::Float&>(left).value) == bits(static_cast<const object::Float&>(right).value);
+            case object::Type::String:
+                return static_cast<const object::String&>(left).value == static_cast<const object::String&>(right).value;
+            case object::Type::Boolean:
+                return static_cast<const object::Boolean&>(left).value == static_cast<const object::Boolean&>(right).value;
+            default:
+                return false;
+        }
+    }
+}
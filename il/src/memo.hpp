@@ -0,0 +1,32 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+
+#include "object.hpp"
+
+namespace memo {
+    // Cache of the results of a pure function, keyed on its arguments
+    // It's direct-mapped: a new result evicts the one in its slot, so it never grows beyond its capacity
+    class Table {
+    public:
+        static constexpr std::size_t CAPACITY {4096u};  // Power of two
+
+        // Only none, integers, floats, strings and booleans can be part of a key
+        static bool hash(const std::vector<std::shared_ptr<object::Object>>& arguments, std::size_t& result);
+
+        std::shared_ptr<object::Object> find(const std::vector<std::shared_ptr<object::Object>>& arguments, std::size_t hash) const;
+        void insert(const std::vector<std::shared_ptr<object::Object>>& arguments, std::size_t hash, std::shared_ptr<object::Object> result);
+    private:
+        struct Entry {
+            std::size_t hash {};
+            std::vector<std::shared_ptr<object::Object>> arguments;
+            std::shared_ptr<object::Object> result;  // Null for empty slots
+        };
+
+        static bool equal(const object::Object& left, const object::Object& right);
+
+        std::vector<Entry> entries;  // Allocated on the first insertion
+    };
+}
@@ -0,0 +1,86 @@
+#include "numeric.hpp"
+
+#include <charconv>
+#include <system_error>
+#include <cassert>
+
+namespace numeric {
+    static std::string_view skip_prefix(std::string_view string) {
+        std::size_t i {0u};
+
+        while (i < string.size() && (string[i] == ' ' || (string[i] >= '\t' && string[i] <= '\r'))) {
+            i++;
+        }
+
+        // from_chars doesn't accept a plus sign, but a minus sign must remain
+        if (i + 1u < string.size() && string[i] == '+' && string[i + 1u] != '-') {
+            i++;
+        }
+
+        return string.substr(i);
+    }
+
+    template<typename T>
+    static Error parse_number(std::string_view string, T& result) {
+        const std::string_view trimmed {skip_prefix(string)};
+
+        const auto [_, error] {std::from_chars(trimmed.data(), trimmed.data() + trimmed.size(), result)};
+
+        if (error == std::errc()) {
+            return Error::None;
+        }
+
+        if (error == std::errc::result_out_of_range) {
+            return Error::OutOfRange;
+        }
+
+        return Error::Invalid;
+    }
+
+    char* format(char* buffer, long long value) {
+        const auto [pointer, error] {std::to_chars(buffer, buffer + MAX_CHARS, value)};
+
+        assert(error == std::errc());
+
+        return pointer;
+    }
+
+    char* format(char* buffer, double value) {
+        // Leave room for the suffix
+        const auto [pointer, error] {std::to_chars(buffer, buffer + MAX_CHARS - 2u, value)};
+
+        assert(error == std::errc());
+
+        // Floats must look like floats, so that 1.0 is not printed as 1
+        for (const char* character {buffer}; character != pointer; character++) {
+            if (*character == '.' || *character == 'e' || *character == 'n' || *character == 'i') {
+                return pointer;
+            }
+        }
+
+        pointer[0u] = '.';
+        pointer[1u] = '0';
+
+        return pointer + 2u;
+    }
+
+    std::string to_string(long long value) {
+        char buffer[MAX_CHARS];
+
+        return std::string(buffer, format(buffer, value));
+    }
+
+    std::string to_string(double value) {
+        char buffer[MAX_CHARS];
+
+        return std::string(buffer, format(buffer, value));
+    }
+
+    Error parse(std::string_view string, long long& result) {
+        return parse_number(string, result);
+    }
+
+    Error parse(std::string_view string, double& result) {
+        return parse_number(string, result);
+    }
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+namespace numeric {
+    enum class Error {
+        None,
+        Invalid,
+        OutOfRange
+    };
+
+    // Large enough for any long long and for the shortest representation of any double
+    inline constexpr std::size_t MAX_CHARS {32u};
+
+    // Write the textual representation into the buffer and return the past-the-end pointer
+    // The buffer must have at least MAX_CHARS characters
+    char* format(char* buffer, long long value);
+    char* format(char* buffer, double value);
+
+    std::string to_string(long long value);
+    std::string to_string(double value);  // Shortest representation that round-trips
+
+    // Leading whitespace and a plus sign are accepted, trailing characters are ignored
+    Error parse(std::string_view string, long long& result);
+    Error parse(std::string_view string, double& result);
+}
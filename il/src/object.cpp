@@ -1,45 +1,108 @@
 #include "object.hpp"
 
+#include <vector>
+#include <algorithm>
 #include <utility>
 #include <cassert>
 
 #include "ast.hpp"
+#include "numeric.hpp"
+#include "output.hpp"
 #include "interpreter.hpp"
 #include "environment.hpp"
 #include "return.hpp"
+#include "memo.hpp"
+#include "lazy.hpp"
+#include "profiler.hpp"
 #include "runtime_error.hpp"
+#include "transfer.hpp"
 
 namespace object {
     namespace interned {
-        static std::shared_ptr<None> none;
-        static std::shared_ptr<Boolean> true_;
-        static std::shared_ptr<Boolean> false_;
-        static std::shared_ptr<Integer> integers[262u];
-
         static constexpr long long INTEGER_MIN {-5ll};
         static constexpr long long INTEGER_MAX {256ll};
         static constexpr long long INTEGER_OFFSET {5ll};
 
-        void initialize() {
-            none = std::make_shared<None>();
-            none->type = Type::None;
+        struct Table {
+            std::shared_ptr<None> none;
+            std::shared_ptr<Boolean> true_;
+            std::shared_ptr<Boolean> false_;
+            std::shared_ptr<Integer> integers[262u];
+        };
+
+        // Every thread has its own interned objects, so that interpreters running in parallel don't contend on
+        // their reference counts; the plain pointer is what the hot paths read, the owner only frees the table
+        static thread_local Table* table {nullptr};
+        static thread_local std::unique_ptr<Table> owner;
 
-            true_ = std::make_shared<Boolean>();
-            true_->type = Type::Boolean;
-            true_->value = true;
+        static Table& create() {
+            owner = std::make_unique<Table>();
+            table = owner.get();
 
-            false_ = std::make_shared<Boolean>();
-            false_->type = Type::Boolean;
-            false_->value = false;
+            table->none = std::make_shared<None>();
+            table->none->type = Type::None;
+
+            table->true_ = std::make_shared<Boolean>();
+            table->true_->type = Type::Boolean;
+            table->true_->value = true;
+
+            table->false_ = std::make_shared<Boolean>();
+            table->false_->type = Type::Boolean;
+            table->false_->value = false;
 
             for (long long i {INTEGER_MIN}; i <= INTEGER_MAX; i++) {
-                integers[i + INTEGER_OFFSET] = std::make_shared<Integer>();
-                integers[i + INTEGER_OFFSET]->type = Type::Integer;
-                integers[i + INTEGER_OFFSET]->value = i;
+                auto& integer {table->integers[i + INTEGER_OFFSET]};
+
+                integer = std::make_shared<Integer>();
+                integer->type = Type::Integer;
+                integer->value = i;
             }
+
+            return *table;
+        }
+
+        // Interpreters may be created on one thread and run on another, so the table is created on first use
+        static Table& get() {
+            return table != nullptr ? *table : create();
+        }
+
+        void initialize() {
+            get();
         }
     }
 
+    namespace printing {
+        // Containers being printed on this thread, innermost last
+        static thread_local std::vector<const Object*> containers;
+
+        // Held while printing the elements of a container; a container reached again inside itself is printed as
+        // an ellipsis instead of recursing forever
+        class Guard {
+        public:
+            explicit Guard(const Object* container)
+                : repeated(std::find(containers.cbegin(), containers.cend(), container) != containers.cend()) {
+                if (!repeated) {
+                    containers.push_back(container);
+                }
+            }
+
+            ~Guard() noexcept {
+                if (!repeated) {
+                    containers.pop_back();
+                }
+            }
+
+            Guard(const Guard&) = delete;
+            Guard& operator=(const Guard&) = delete;
+
+            const bool repeated;
+        };
+    }
+
+    void Object::write(Output& output) const {
+        output.write(to_string());
+    }
+
     std::string None::to_string() const {
         return "none";
     }
@@ -49,17 +112,37 @@ namespace object {
     }
 
     std::string Integer::to_string() const {
-        return std::to_string(value);
+        return numeric::to_string(value);
     }
 
     std::string Float::to_string() const {
-        return std::to_string(value);
+        return numeric::to_string(value);
     }
 
     std::string Boolean::to_string() const {
         return value ? "true" : "false";
     }
 
+    void None::write(Output& output) const {
+        output.write("none");
+    }
+
+    void String::write(Output& output) const {
+        output.write(value);
+    }
+
+    void Integer::write(Output& output) const {
+        output.write(value);
+    }
+
+    void Float::write(Output& output) const {
+        output.write(value);
+    }
+
+    void Boolean::write(Output& output) const {
+        output.write(value ? "true" : "false");
+    }
+
     std::string BuiltinFunction::to_string() const {
         return "<builtin function>";
     }
@@ -80,6 +163,203 @@ namespace object {
         return "<" + struct_->name + " instance>";
     }
 
+    std::string Array::to_string() const {
+        const printing::Guard guard {this};
+
+        if (guard.repeated) {
+            return "[...]";
+        }
+
+        std::string result {"["};
+
+        for (std::size_t i {0u}; i < elements.size(); i++) {
+            if (i > 0u) {
+                result += ", ";
+            }
+
+            result += elements[i]->to_string();
+        }
+
+        return result + "]";
+    }
+
+    void Array::write(Output& output) const {
+        const printing::Guard guard {this};
+
+        if (guard.repeated) {
+            output.write("[...]");
+            return;
+        }
+
+        output.write('[');
+
+        for (std::size_t i {0u}; i < elements.size(); i++) {
+            if (i > 0u) {
+                output.write(", ");
+            }
+
+            elements[i]->write(output);
+        }
+
+        output.write(']');
+    }
+
+    std::string Map::to_string() const {
+        const printing::Guard guard {this};
+
+        if (guard.repeated) {
+            return "{...}";
+        }
+
+        std::string result {"{"};
+        bool first {true};
+
+        entries.for_each([&](const std::shared_ptr<Object>& key, const std::shared_ptr<Object>& value) {
+            if (!first) {
+                result += ", ";
+            }
+
+            first = false;
+            result += key->to_string() + ": " + value->to_string();
+        });
+
+        return result + "}";
+    }
+
+    void Map::write(Output& output) const {
+        const printing::Guard guard {this};
+
+        if (guard.repeated) {
+            output.write("{...}");
+            return;
+        }
+
+        output.write('{');
+        bool first {true};
+
+        entries.for_each([&](const std::shared_ptr<Object>& key, const std::shared_ptr<Object>& value) {
+            if (!first) {
+                output.write(", ");
+            }
+
+            first = false;
+            key->write(output);
+            output.write(": ");
+            value->write(output);
+        });
+
+        output.write('}');
+    }
+
+    std::string IntArray::to_string() const {
+        std::string result {"["};
+
+        for (std::size_t i {0u}; i < values.size(); i++) {
+            if (i > 0u) {
+                result += ", ";
+            }
+
+            result += numeric::to_string(values[i]);
+        }
+
+        return result + "]";
+    }
+
+    void IntArray::write(Output& output) const {
+        output.write('[');
+
+        for (std::size_t i {0u}; i < values.size(); i++) {
+            if (i > 0u) {
+                output.write(", ");
+            }
+
+            output.write(values[i]);
+        }
+
+        output.write(']');
+    }
+
+    std::string FloatArray::to_string() const {
+        std::string result {"["};
+
+        for (std::size_t i {0u}; i < values.size(); i++) {
+            if (i > 0u) {
+                result += ", ";
+            }
+
+            result += numeric::to_string(values[i]);
+        }
+
+        return result + "]";
+    }
+
+    void FloatArray::write(Output& output) const {
+        output.write('[');
+
+        for (std::size_t i {0u}; i < values.size(); i++) {
+            if (i > 0u) {
+                output.write(", ");
+            }
+
+            output.write(values[i]);
+        }
+
+        output.write(']');
+    }
+
+    std::string Task::to_string() const {
+        return "<task>";
+    }
+
+    std::string Channel::to_string() const {
+        return "<channel>";
+    }
+
+    std::string Set::to_string() const {
+        const printing::Guard guard {this};
+
+        if (guard.repeated) {
+            return "{...}";
+        }
+
+        std::string result {"{"};
+        bool first {true};
+
+        elements.for_each([&](const std::shared_ptr<Object>& element, const std::shared_ptr<Object>&) {
+            if (!first) {
+                result += ", ";
+            }
+
+            first = false;
+            result += element->to_string();
+        });
+
+        return result + "}";
+    }
+
+    void Set::write(Output& output) const {
+        const printing::Guard guard {this};
+
+        if (guard.repeated) {
+            output.write("{...}");
+            return;
+        }
+
+        output.write('{');
+        bool first {true};
+
+        elements.for_each([&](const std::shared_ptr<Object>& element, const std::shared_ptr<Object>&) {
+            if (!first) {
+                output.write(", ");
+            }
+
+            first = false;
+            element->write(output);
+        });
+
+        output.write('}');
+    }
+
     std::shared_ptr<Object> StructInstance::get(const token::Token& name) const {
         if (fields.find(name.get_lexeme()) != fields.cend()) {
             return fields.at(name.get_lexeme());
@@ -101,21 +381,84 @@ namespace object {
         const std::vector<std::shared_ptr<Object>>& arguments,
         const token::Token&
     ) {
-        Environment environment {&interpreter->global_environment};
+        std::size_t hash {};
+
+        // Arguments of other types are not cached
+        if (memo == nullptr || !memo::Table::hash(arguments, hash)) {
+            return invoke(interpreter, arguments);
+        }
 
-        // Create all the local variables
-        for (std::size_t i {0u}; i < parameters.size(); i++) {
-            environment.define(parameters[i].get_lexeme(), arguments[i]);
+        std::shared_ptr<Object> result {memo->find(arguments, hash)};
+
+        if (result != nullptr) {
+            IL_STATS(stats::counters.memo_hits++);
+            return result;
         }
 
-        // Using exceptions for control flow, not great
-        try {
-            interpreter->execute(body, std::move(environment));
-        } catch (const Return& return_value) {
-            return return_value.value;
+        IL_STATS(stats::counters.memo_misses++);
+
+        result = invoke(interpreter, arguments);
+
+        // Every caller would get the same mutable object, so modifying it would change the cached result
+        if (transfer::immutable(*result)) {
+            memo->insert(arguments, hash, result);
         }
 
-        return create_none();
+        return result;
+    }
+
+    std::shared_ptr<Object> Function::invoke(Interpreter* interpreter, const std::vector<std::shared_ptr<Object>>& arguments) {
+        // Tail calls to other functions replace the current one and run in this same loop
+        const Function* function {this};
+        const std::vector<std::shared_ptr<Object>>* function_arguments {&arguments};
+
+        std::shared_ptr<Object> tail_callee;
+        std::vector<std::shared_ptr<Object>> tail_arguments;
+
+        while (true) {
+            IL_STATS(function->type == Type::Method ? stats::counters.method_calls++ : stats::counters.function_calls++);
+
+            Environment environment {&interpreter->global_environment};
+
+            // Create all the local variables
+            for (std::size_t i {0u}; i < function->parameters.size(); i++) {
+                environment.define(function->parameters[i].get_lexeme(), (*function_arguments)[i]);
+            }
+
+            interpreter->execute(lazy::body(*function), std::move(environment));
+
+            if (!interpreter->returning) {
+                return create_none();
+            }
+
+            interpreter->returning = false;
+
+            Return return_value {std::move(interpreter->return_value)};
+            interpreter->return_value = Return();
+
+            if (return_value.callee == nullptr) {
+                return return_value.value;
+            }
+
+            profiler::replace(interpreter->sampler, interpreter->tracer, return_value.callee);
+
+            const bool function_callee {
+                return_value.callee->type == Type::Function || return_value.callee->type == Type::Method
+            };
+
+            // Memoized functions must go through their cache
+            if (!function_callee || cast<Function>(return_value.callee)->memo != nullptr) {
+                IL_STATS(if (return_value.callee->type == Type::BuiltinFunction) stats::counters.builtin_calls++);
+
+                return as_callable(return_value.callee)->call(interpreter, return_value.arguments, *return_value.token);
+            }
+
+            tail_callee = std::move(return_value.callee);
+            tail_arguments = std::move(return_value.arguments);
+
+            function = cast<Function>(tail_callee).get();
+            function_arguments = &tail_arguments;
+        }
     }
 
     std::size_t Function::arity() const {
@@ -127,6 +470,8 @@ namespace object {
         const std::vector<std::shared_ptr<Object>>& arguments,
         const token::Token& token
     ) {
+        IL_STATS(stats::counters.struct_instantiations++);
+
         std::shared_ptr<StructInstance> instance {cast<StructInstance>(create_struct_instance(shared_from_this()))};
 
         // Bind the instance to the methods
@@ -141,6 +486,9 @@ namespace object {
         arguments_and_self.insert(arguments_and_self.cbegin(), instance);
 
         if (methods.find("init") != methods.cend()) {
+            // Recorded as a call of its own, named after the struct by the method bound to the instance
+            profiler::Frame frame {interpreter->sampler, interpreter->tracer, instance->methods.at("init")};
+
             methods.at("init")->call(interpreter, arguments_and_self, token);
         }
 
@@ -155,13 +503,28 @@ namespace object {
         return 1u;
     }
 
+    Callable* as_callable(const std::shared_ptr<Object>& object) {
+        switch (object->type) {
+            case Type::BuiltinFunction:
+                return cast<BuiltinFunction>(object).get();
+            case Type::Function:
+            case Type::Method:
+                return cast<Function>(object).get();
+            case Type::Struct:
+                return cast<Struct>(object).get();
+            default:
+                return nullptr;
+        }
+    }
+
     std::shared_ptr<Object> create_none() {
-        return interned::none;
+        return interned::get().none;
     }
 
     std::shared_ptr<Object> create_string(const std::string& value) {
         std::shared_ptr<String> object {std::make_shared<String>()};
         object->type = Type::String;
+        IL_STATS(stats::allocated(Type::String));
         object->value = value;
 
         return object;
@@ -169,11 +532,15 @@ namespace object {
 
     std::shared_ptr<Object> create_integer(long long value) {
         if (value >= interned::INTEGER_MIN && value <= interned::INTEGER_MAX) {
-            return interned::integers[value + interned::INTEGER_OFFSET];
+            IL_STATS(stats::counters.integer_cache_hits++);
+            return interned::get().integers[value + interned::INTEGER_OFFSET];
         }
 
+        IL_STATS(stats::counters.integer_cache_misses++);
+
         std::shared_ptr<Integer> object {std::make_shared<Integer>()};
         object->type = Type::Integer;
+        IL_STATS(stats::allocated(Type::Integer));
         object->value = value;
 
         return object;
@@ -182,24 +549,35 @@ namespace object {
     std::shared_ptr<Object> create_float(double value) {
         std::shared_ptr<Float> object {std::make_shared<Float>()};
         object->type = Type::Float;
+        IL_STATS(stats::allocated(Type::Float));
         object->value = value;
 
         return object;
     }
 
     std::shared_ptr<Object> create_bool(bool value) {
-        return value ? interned::true_ : interned::false_;
+        const interned::Table& table {interned::get()};
+
+        return value ? table.true_ : table.false_;
     }
 
     std::shared_ptr<Object> create_function(
         const token::Token& name,
         const std::vector<token::Token>& parameters,
-        const std::vector<std::shared_ptr<ast::stmt::Stmt<std::shared_ptr<Object>>>>& body
+        const std::vector<std::shared_ptr<ast::stmt::Stmt<std::shared_ptr<Object>>>>& body,
+        bool memoized,
+        std::shared_ptr<lazy::Body> lazy
     ) {
         std::shared_ptr<Function> object {std::make_shared<Function>(name)};
         object->type = Type::Function;
+        IL_STATS(stats::allocated(Type::Function));
         object->parameters = parameters;
         object->body = body;
+        object->lazy = std::move(lazy);
+
+        if (memoized) {
+            object->memo = std::make_shared<memo::Table>();
+        }
 
         return object;
     }
@@ -210,6 +588,7 @@ namespace object {
     ) {
         std::shared_ptr<Struct> object {std::make_shared<Struct>()};
         object->type = Type::Struct;
+        IL_STATS(stats::allocated(Type::Struct));
         object->name = name;
         object->methods = methods;
 
@@ -219,25 +598,91 @@ namespace object {
     std::shared_ptr<Object> create_struct_instance(std::shared_ptr<Struct> struct_) {
         std::shared_ptr<StructInstance> object {std::make_shared<StructInstance>()};
         object->type = Type::StructInstance;
+        IL_STATS(stats::allocated(Type::StructInstance));
         object->struct_ = struct_;
 
         // Create deep copies of the methods
         for (const auto& [name, method] : struct_->methods) {
             object->methods[name] = std::make_shared<Method>(*method);
+            IL_STATS(stats::allocated(Type::Method));
         }
 
         return object;
     }
 
+    std::shared_ptr<Object> create_array(std::vector<std::shared_ptr<Object>>&& elements) {
+        std::shared_ptr<Array> object {std::make_shared<Array>()};
+        object->type = Type::Array;
+        IL_STATS(stats::allocated(Type::Array));
+        object->elements = std::move(elements);
+
+        return object;
+    }
+
+    std::shared_ptr<Object> create_map() {
+        std::shared_ptr<Map> object {std::make_shared<Map>()};
+        object->type = Type::Map;
+        IL_STATS(stats::allocated(Type::Map));
+
+        return object;
+    }
+
+    std::shared_ptr<Object> create_set() {
+        std::shared_ptr<Set> object {std::make_shared<Set>()};
+        object->type = Type::Set;
+        IL_STATS(stats::allocated(Type::Set));
+
+        return object;
+    }
+
+    std::shared_ptr<Object> create_int_array(std::vector<long long>&& values) {
+        std::shared_ptr<IntArray> object {std::make_shared<IntArray>()};
+        object->type = Type::IntArray;
+        IL_STATS(stats::allocated(Type::IntArray));
+        object->values = std::move(values);
+
+        return object;
+    }
+
+    std::shared_ptr<Object> create_float_array(std::vector<double>&& values) {
+        std::shared_ptr<FloatArray> object {std::make_shared<FloatArray>()};
+        object->type = Type::FloatArray;
+        IL_STATS(stats::allocated(Type::FloatArray));
+        object->values = std::move(values);
+
+        return object;
+    }
+
+    std::shared_ptr<Object> create_task(std::shared_ptr<tasks::Task> task) {
+        std::shared_ptr<Task> object {std::make_shared<Task>()};
+        object->type = Type::Task;
+        IL_STATS(stats::allocated(Type::Task));
+        object->task = std::move(task);
+
+        return object;
+    }
+
+    std::shared_ptr<Object> create_channel(std::shared_ptr<channels::Channel> channel) {
+        std::shared_ptr<Channel> object {std::make_shared<Channel>()};
+        object->type = Type::Channel;
+        IL_STATS(stats::allocated(Type::Channel));
+        object->channel = std::move(channel);
+
+        return object;
+    }
+
     std::shared_ptr<Object> create_method(
         const token::Token& name,
         const std::vector<token::Token>& parameters,
-        const std::vector<std::shared_ptr<ast::stmt::Stmt<std::shared_ptr<Object>>>>& body
+        const std::vector<std::shared_ptr<ast::stmt::Stmt<std::shared_ptr<Object>>>>& body,
+        std::shared_ptr<lazy::Body> lazy
     ) {
         std::shared_ptr<Method> object {std::make_shared<Method>(name)};
         object->type = Type::Method;
+        IL_STATS(stats::allocated(Type::Method));
         object->parameters = parameters;
         object->body = body;
+        object->lazy = std::move(lazy);
 
         assert(parameters.size() > 0u);
 
@@ -4,13 +4,33 @@
 #include <memory>
 #include <vector>
 #include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <type_traits>
 #include <unordered_map>
 
 #include "token.hpp"
+#include "stats.hpp"
+#include "table.hpp"
 
 class Interpreter;
+class Output;
+
+namespace memo {
+    class Table;
+}
+
+namespace tasks {
+    class Task;
+}
+
+namespace channels {
+    class Channel;
+}
+
+namespace lazy {
+    class Body;
+}
 
 namespace ast {
     namespace stmt {
@@ -34,7 +54,14 @@ namespace object {
         Function,
         Method,
         Struct,
-        StructInstance
+        StructInstance,
+        Array,
+        Map,
+        Set,
+        IntArray,
+        FloatArray,
+        Task,
+        Channel
     };
 
     struct Object {
@@ -42,7 +69,14 @@ namespace object {
 
         virtual std::string to_string() const = 0;
 
+        // Format directly into the output buffer; by default it goes through to_string()
+        virtual void write(Output& output) const;
+
         Type type {};
+
+#ifdef IL_ENABLE_STATS
+        stats::Tracker tracker;
+#endif
     };
 
     struct Callable {
@@ -55,38 +89,53 @@ namespace object {
         ) = 0;
 
         virtual std::size_t arity() const = 0;
+
+        // Variadic callables take at least arity() arguments
+        virtual bool variadic() const { return false; }
+
+        std::uint32_t profile_id {};  // Assigned by the profilers on the first call; zero means unassigned
     };
 
     struct None : Object {
         std::string to_string() const override;
+        void write(Output& output) const override;
     };
 
     struct String : Object {
         std::string to_string() const override;
+        void write(Output& output) const override;
 
         std::string value;
     };
 
     struct Integer : Object {
         std::string to_string() const override;
+        void write(Output& output) const override;
 
         long long value {};
     };
 
     struct Float : Object {
         std::string to_string() const override;
+        void write(Output& output) const override;
 
         double value {};
     };
 
     struct Boolean : Object {
         std::string to_string() const override;
+        void write(Output& output) const override;
 
         bool value {};
     };
 
+    // Every builtin declares a static constexpr bool PURE, which is false if its result depends on something else
+    // than its arguments or if it has side effects
     struct BuiltinFunction : Object, Callable {
         std::string to_string() const override;
+
+        std::string name;
+        bool pure {false};
     };
 
     struct Function : Object, Callable {
@@ -106,6 +155,10 @@ namespace object {
         token::Token name;
         std::vector<token::Token> parameters;
         std::vector<std::shared_ptr<ast::stmt::Stmt<std::shared_ptr<Object>>>> body;
+        std::shared_ptr<memo::Table> memo;  // Null unless the function is memoized
+        std::shared_ptr<lazy::Body> lazy;  // Instead of the body, until the first call
+    private:
+        std::shared_ptr<Object> invoke(Interpreter* interpreter, const std::vector<std::shared_ptr<Object>>& arguments);
     };
 
     struct Method : Function {
@@ -144,6 +197,56 @@ namespace object {
         std::unordered_map<std::string, std::shared_ptr<Object>> fields;
     };
 
+    struct Array : Object {
+        std::string to_string() const override;
+        void write(Output& output) const override;
+
+        std::vector<std::shared_ptr<Object>> elements;
+    };
+
+    struct Map : Object {
+        std::string to_string() const override;
+        void write(Output& output) const override;
+
+        table::Table entries;
+    };
+
+    struct Set : Object {
+        std::string to_string() const override;
+        void write(Output& output) const override;
+
+        table::Table elements;  // Only the keys are used
+    };
+
+    // Homogeneous arrays of unboxed numbers, for the vectorized builtins
+    struct IntArray : Object {
+        std::string to_string() const override;
+        void write(Output& output) const override;
+
+        std::vector<long long> values;
+    };
+
+    struct FloatArray : Object {
+        std::string to_string() const override;
+        void write(Output& output) const override;
+
+        std::vector<double> values;
+    };
+
+    // Handle of a function call spawned on the thread pool
+    struct Task : Object {
+        std::string to_string() const override;
+
+        std::shared_ptr<tasks::Task> task;
+    };
+
+    // Every interpreter using a channel has an object of its own, all referring to the same channel
+    struct Channel : Object {
+        std::string to_string() const override;
+
+        std::shared_ptr<channels::Channel> channel;
+    };
+
     std::shared_ptr<Object> create_none();
     std::shared_ptr<Object> create_string(const std::string& value);
     std::shared_ptr<Object> create_integer(long long value);
@@ -153,13 +256,16 @@ namespace object {
     std::shared_ptr<Object> create_function(
         const token::Token& name,
         const std::vector<token::Token>& parameters,
-        const std::vector<std::shared_ptr<ast::stmt::Stmt<std::shared_ptr<Object>>>>& body
+        const std::vector<std::shared_ptr<ast::stmt::Stmt<std::shared_ptr<Object>>>>& body,
+        bool memoized = false,
+        std::shared_ptr<lazy::Body> lazy = nullptr
     );
 
     std::shared_ptr<Object> create_method(
         const token::Token& name,
         const std::vector<token::Token>& parameters,
-        const std::vector<std::shared_ptr<ast::stmt::Stmt<std::shared_ptr<Object>>>>& body
+        const std::vector<std::shared_ptr<ast::stmt::Stmt<std::shared_ptr<Object>>>>& body,
+        std::shared_ptr<lazy::Body> lazy = nullptr
     );
 
     std::shared_ptr<Object> create_struct(
@@ -168,17 +274,31 @@ namespace object {
     );
 
     std::shared_ptr<Object> create_struct_instance(std::shared_ptr<Struct> struct_);
+    std::shared_ptr<Object> create_array(std::vector<std::shared_ptr<Object>>&& elements);
+    std::shared_ptr<Object> create_map();
+    std::shared_ptr<Object> create_set();
+    std::shared_ptr<Object> create_int_array(std::vector<long long>&& values);
+    std::shared_ptr<Object> create_float_array(std::vector<double>&& values);
+    std::shared_ptr<Object> create_task(std::shared_ptr<tasks::Task> task);
+    std::shared_ptr<Object> create_channel(std::shared_ptr<channels::Channel> channel);
 
     template<typename T>
-    std::shared_ptr<Object> create_builtin_function() {
+    std::shared_ptr<Object> create_builtin_function(const std::string& name) {
         static_assert(std::is_base_of_v<BuiltinFunction, T>, "Type must be a builtin function derived class");
 
         std::shared_ptr<T> object {std::make_shared<T>()};
         object->type = Type::BuiltinFunction;
+        object->name = name;
+        object->pure = T::PURE;
+
+        IL_STATS(stats::allocated(Type::BuiltinFunction));
 
         return object;
     }
 
+    // Null for objects that cannot be called
+    Callable* as_callable(const std::shared_ptr<Object>& object);
+
     template<typename T>
     std::shared_ptr<T> cast(const std::shared_ptr<Object>& object) {
         return std::static_pointer_cast<T>(object);
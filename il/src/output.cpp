@@ -0,0 +1,76 @@
+#include "output.hpp"
+
+#include <cstring>
+
+#include "numeric.hpp"
+
+Output::Output(std::ostream* stream, std::size_t capacity)
+    : stream(stream) {
+    set_capacity(capacity);
+}
+
+Output::~Output() noexcept {
+    flush();
+}
+
+void Output::write(char character) {
+    if (size == capacity) {
+        flush();
+    }
+
+    buffer[size++] = character;
+}
+
+void Output::write(std::string_view string) {
+    if (string.size() > capacity - size) {
+        flush();
+
+        // Don't bother copying strings that wouldn't fit anyway
+        if (string.size() > capacity) {
+            stream->write(string.data(), static_cast<std::streamsize>(string.size()));
+            return;
+        }
+    }
+
+    std::memcpy(buffer.get() + size, string.data(), string.size());
+    size += string.size();
+}
+
+void Output::write(long long value) {
+    if (capacity - size < numeric::MAX_CHARS) {
+        flush();
+    }
+
+    size = static_cast<std::size_t>(numeric::format(buffer.get() + size, value) - buffer.get());
+}
+
+void Output::write(double value) {
+    if (capacity - size < numeric::MAX_CHARS) {
+        flush();
+    }
+
+    size = static_cast<std::size_t>(numeric::format(buffer.get() + size, value) - buffer.get());
+}
+
+void Output::flush() {
+    if (size > 0u) {
+        stream->write(buffer.get(), static_cast<std::streamsize>(size));
+        size = 0u;
+    }
+
+    stream->flush();
+}
+
+void Output::set_capacity(std::size_t capacity) {
+    if (buffer != nullptr) {
+        flush();
+    }
+
+    // Numbers are formatted in place, so there must be room for at least one
+    if (capacity < numeric::MAX_CHARS) {
+        capacity = numeric::MAX_CHARS;
+    }
+
+    buffer = std::make_unique<char[]>(capacity);
+    this->capacity = capacity;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <ostream>
+#include <string_view>
+#include <cstddef>
+#include <memory>
+
+// Buffered writer used by the builtins for all standard output
+// Flushing happens when the buffer fills up, when explicitly requested and at destruction
+class Output {
+public:
+    static constexpr std::size_t DEFAULT_CAPACITY {65536u};
+
+    explicit Output(std::ostream* stream, std::size_t capacity = DEFAULT_CAPACITY);
+    ~Output() noexcept;
+
+    Output(const Output&) = delete;
+    Output& operator=(const Output&) = delete;
+    Output(Output&&) = delete;
+    Output& operator=(Output&&) = delete;
+
+    void write(char character);
+    void write(std::string_view string);
+    void write(long long value);
+    void write(double value);
+    void flush();
+
+    void set_capacity(std::size_t capacity);  // Flushes first
+    std::size_t get_capacity() const { return capacity; }
+private:
+    std::unique_ptr<char[]> buffer;
+    std::size_t capacity {};
+    std::size_t size {};
+
+    std::ostream* stream {nullptr};
+};
@@ -1,5 +1,7 @@
 #include "parser.hpp"
 
+#include "lazy.hpp"
+
 bool Parser::match(std::initializer_list<token::TokenType> types) {
     for (const token::TokenType type : types) {
         if (check(type)) {
@@ -32,11 +34,11 @@ bool Parser::reached_end() {
 }
 
 const token::Token& Parser::peek() {
-    return tokens[current];
+    return (*tokens)[current];
 }
 
 const token::Token& Parser::previous() {
-    return tokens[current - 1u];
+    return (*tokens)[current - 1u];
 }
 
 const token::Token& Parser::consume(token::TokenType type, const std::string& message) {
@@ -77,3 +79,20 @@ void Parser::synchronize() {
         advance();
     }
 }
+
+std::shared_ptr<lazy::Body> Parser::skip_body(const token::Token& name, bool memoized) {
+    const std::size_t begin {current};
+    std::size_t depth {1u};
+
+    while (!reached_end()) {
+        const token::TokenType type {advance().get_type()};
+
+        if (type == token::TokenType::LeftBrace) {
+            depth++;
+        } else if (type == token::TokenType::RightBrace && --depth == 0u) {
+            return std::make_shared<lazy::Body>(tokens, begin, current - 1u, name, memoized);
+        }
+    }
+
+    throw error(peek(), "Excpected `}` after block");
+}
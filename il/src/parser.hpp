@@ -5,6 +5,8 @@
 #include <memory>
 #include <initializer_list>
 #include <string>
+#include <type_traits>
+#include <utility>
 #include <cassert>
 
 #include "token.hpp"
@@ -12,10 +14,18 @@
 #include "context.hpp"
 #include "object.hpp"
 
+namespace lazy {
+    class Body;
+}
+
 class Parser {
 public:
-    Parser(const std::vector<token::Token>& tokens, Context* ctx)
-        : tokens(tokens), ctx(ctx) {}
+    // Lazy parsers only match the braces of function bodies, leaving them to lazy::Body
+    Parser(const std::vector<token::Token>& tokens, Context* ctx, bool lazy = false)
+        : tokens(std::make_shared<const std::vector<token::Token>>(tokens)), ctx(ctx), lazy(lazy) {}
+
+    Parser(std::vector<token::Token>&& tokens, Context* ctx, bool lazy = false)
+        : tokens(std::make_shared<const std::vector<token::Token>>(std::move(tokens))), ctx(ctx), lazy(lazy) {}
 
     template<typename R>
     std::vector<std::shared_ptr<ast::stmt::Stmt<R>>> parse() {
@@ -27,22 +37,40 @@ public:
 
         return statements;
     }
+
+    // The body of a function on its own, from after its opening brace to its closing brace
+    template<typename R>
+    std::vector<std::shared_ptr<ast::stmt::Stmt<R>>> parse_body() {
+        try {
+            return block<R>();
+        } catch (ParseError) {
+            return {};
+        }
+    }
 private:
     using ParseError = int;
 
     template<typename R>
     std::shared_ptr<ast::stmt::Stmt<R>> declaration() {
+        const std::size_t line {peek().get_line()};
+
         try {
             if (match({token::TokenType::Let})) {
-                return var_declaration<R>();
+                return at_line<R>(var_declaration<R>(), line);
             }
 
             if (match({token::TokenType::Fun})) {
-                return fun_declaration<R>();
+                return at_line<R>(fun_declaration<R>(), line);
+            }
+
+            if (match({token::TokenType::Memo})) {
+                consume(token::TokenType::Fun, "Expected `fun` after `memo`");
+
+                return at_line<R>(fun_declaration<R>(true), line);
             }
 
             if (match({token::TokenType::Struct})) {
-                return struct_declaration<R>();
+                return at_line<R>(struct_declaration<R>(), line);
             }
 
             return statement<R>();
@@ -55,27 +83,36 @@ private:
 
     template<typename R>
     std::shared_ptr<ast::stmt::Stmt<R>> statement() {
+        const std::size_t line {peek().get_line()};
+
         if (match({token::TokenType::LeftBrace})) {
-            return std::make_shared<ast::stmt::Block<R>>(block<R>());
+            return at_line<R>(std::make_shared<ast::stmt::Block<R>>(block<R>()), line);
         }
 
         if (match({token::TokenType::If})) {
-            return if_statement<R>();
+            return at_line<R>(if_statement<R>(), line);
         }
 
         if (match({token::TokenType::While})) {
-            return while_statement<R>();
+            return at_line<R>(while_statement<R>(), line);
         }
 
         if (match({token::TokenType::For})) {
-            return for_statement<R>();
+            return at_line<R>(for_statement<R>(), line);
         }
 
         if (match({token::TokenType::Return})) {
-            return return_statement<R>();
+            return at_line<R>(return_statement<R>(), line);
         }
 
-        return expr_statement<R>();
+        return at_line<R>(expr_statement<R>(), line);
+    }
+
+    template<typename R>
+    static std::shared_ptr<ast::stmt::Stmt<R>> at_line(std::shared_ptr<ast::stmt::Stmt<R>> stmt, std::size_t line) {
+        stmt->line = line;
+
+        return stmt;
     }
 
     template<typename R>
@@ -94,12 +131,12 @@ private:
     }
 
     template<typename R>
-    std::shared_ptr<ast::stmt::Stmt<R>> fun_declaration() {
-        return function<R>();
+    std::shared_ptr<ast::stmt::Stmt<R>> fun_declaration(bool memoized = false) {
+        return function<R>(memoized);
     }
 
     template<typename R>
-    std::shared_ptr<ast::stmt::Stmt<R>> function() {
+    std::shared_ptr<ast::stmt::Stmt<R>> function(bool memoized = false) {
         const token::Token& name {consume(token::TokenType::Identifier, "Expected a function name")};
 
         consume(token::TokenType::LeftParen, "Expected `(` after function name");
@@ -120,9 +157,18 @@ private:
 
         consume(token::TokenType::LeftBrace, "Expected `{` before function body");
 
+        if constexpr (std::is_same_v<R, std::shared_ptr<object::Object>>) {
+            if (lazy) {
+                auto function {std::make_shared<ast::stmt::Function<R>>(name, parameters, std::vector<std::shared_ptr<ast::stmt::Stmt<R>>>(), memoized)};
+                function->lazy = skip_body(name, memoized);
+
+                return at_line<R>(function, name.get_line());
+            }
+        }
+
         const std::vector<std::shared_ptr<ast::stmt::Stmt<R>>> body {block<R>()};
 
-        return std::make_shared<ast::stmt::Function<R>>(name, parameters, body);
+        return at_line<R>(std::make_shared<ast::stmt::Function<R>>(name, parameters, body, memoized), name.get_line());
     }
 
     template<typename R>
@@ -184,6 +230,10 @@ private:
 
     template<typename R>
     std::shared_ptr<ast::stmt::Stmt<R>> for_statement() {
+        if (match({token::TokenType::Identifier})) {
+            return for_range_statement<R>();
+        }
+
         const token::Token& paren {consume(token::TokenType::LeftParen, "Expected `(` after `for`")};
 
         std::shared_ptr<ast::stmt::Stmt<R>> initializer;
@@ -241,6 +291,41 @@ private:
         return body;
     }
 
+    template<typename R>
+    std::shared_ptr<ast::stmt::Stmt<R>> for_range_statement() {
+        const token::Token& name {previous()};
+
+        consume(token::TokenType::In, "Expected `in` after loop variable");
+
+        const token::Token& range {consume(token::TokenType::Identifier, "Expected `range` after `in`")};
+
+        if (range.get_lexeme() != "range") {
+            throw error(range, "Expected `range` after `in`");
+        }
+
+        consume(token::TokenType::LeftParen, "Expected `(` after `range`");
+
+        std::vector<std::shared_ptr<ast::expr::Expr<R>>> arguments;
+
+        do {
+            arguments.push_back(expression<R>());
+        } while (arguments.size() < 3u && match({token::TokenType::Comma}));
+
+        consume(token::TokenType::RightParen, "Expected `)` after range arguments");
+
+        std::shared_ptr<ast::stmt::Stmt<R>> body {statement<R>()};
+
+        // Like in Python, range(stop), range(start, stop) or range(start, stop, step)
+        switch (arguments.size()) {
+            case 1u:
+                return std::make_shared<ast::stmt::ForRange<R>>(name, range, nullptr, arguments[0u], nullptr, body);
+            case 2u:
+                return std::make_shared<ast::stmt::ForRange<R>>(name, range, arguments[0u], arguments[1u], nullptr, body);
+            default:
+                return std::make_shared<ast::stmt::ForRange<R>>(name, range, arguments[0u], arguments[1u], arguments[2u], body);
+        }
+    }
+
     template<typename R>
     std::shared_ptr<ast::stmt::Stmt<R>> return_statement() {
         const token::Token& keyword {previous()};
@@ -301,6 +386,14 @@ private:
                 }
             }
 
+            {
+                auto variable {std::dynamic_pointer_cast<ast::expr::Index<R>>(expr)};
+
+                if (variable != nullptr) {
+                    return std::make_shared<ast::expr::IndexSet<R>>(variable->object, variable->bracket, variable->index, value);
+                }
+            }
+
             error(equals, "Invalid assignment target");  // Don't enter panic mode
         }
 
@@ -408,6 +501,11 @@ private:
                 const token::Token& name {consume(token::TokenType::Identifier, "Expected attribute name after `.`")};
 
                 expr = std::make_shared<ast::expr::Get<R>>(expr, name);
+            } else if (match({token::TokenType::LeftBracket})) {
+                std::shared_ptr<ast::expr::Expr<R>> index {expression<R>()};
+                const token::Token& bracket {consume(token::TokenType::RightBracket, "Expected `]` after index")};
+
+                expr = std::make_shared<ast::expr::Index<R>>(expr, bracket, index);
             } else {
                 break;
             }
@@ -455,6 +553,55 @@ private:
             return std::make_shared<ast::expr::Grouping<R>>(expr);
         }
 
+        if (match({token::TokenType::LeftBracket})) {
+            std::vector<std::shared_ptr<ast::expr::Expr<R>>> elements;
+
+            if (!check(token::TokenType::RightBracket)) {
+                do {
+                    elements.push_back(expression<R>());
+                } while (match({token::TokenType::Comma}));
+            }
+
+            const token::Token& bracket {consume(token::TokenType::RightBracket, "Expected `]` after array elements")};
+
+            return std::make_shared<ast::expr::Array<R>>(bracket, elements);
+        }
+
+        if (match({token::TokenType::LeftBrace})) {
+            // `{}` is an empty map; the first element tells maps and sets apart
+            if (match({token::TokenType::RightBrace})) {
+                return std::make_shared<ast::expr::MapLiteral<R>>(
+                    previous(),
+                    std::vector<std::shared_ptr<ast::expr::Expr<R>>>(),
+                    std::vector<std::shared_ptr<ast::expr::Expr<R>>>()
+                );
+            }
+
+            std::vector<std::shared_ptr<ast::expr::Expr<R>>> elements {expression<R>()};
+
+            if (match({token::TokenType::Colon})) {
+                std::vector<std::shared_ptr<ast::expr::Expr<R>>> values {expression<R>()};
+
+                while (match({token::TokenType::Comma})) {
+                    elements.push_back(expression<R>());
+                    consume(token::TokenType::Colon, "Expected `:` after map key");
+                    values.push_back(expression<R>());
+                }
+
+                const token::Token& brace {consume(token::TokenType::RightBrace, "Expected `}` after map entries")};
+
+                return std::make_shared<ast::expr::MapLiteral<R>>(brace, elements, values);
+            }
+
+            while (match({token::TokenType::Comma})) {
+                elements.push_back(expression<R>());
+            }
+
+            const token::Token& brace {consume(token::TokenType::RightBrace, "Expected `}` after set elements")};
+
+            return std::make_shared<ast::expr::SetLiteral<R>>(brace, elements);
+        }
+
         throw error(peek(), "Expected an expression");
     }
 
@@ -486,9 +633,11 @@ private:
     const token::Token& consume(token::TokenType type, const std::string& message);
     ParseError error(const token::Token& token, const std::string& message);
     void synchronize();
+    std::shared_ptr<lazy::Body> skip_body(const token::Token& name, bool memoized);
 
-    std::vector<token::Token> tokens;
+    std::shared_ptr<const std::vector<token::Token>> tokens;  // Shared with the lazy function bodies
     std::size_t current {};
 
     Context* ctx {nullptr};
+    bool lazy {false};
 };
@@ -0,0 +1,438 @@
+#include "profiler.hpp"
+
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <algorithm>
+#include <utility>
+#include <iomanip>
+#include <cassert>
+
+#if defined(__unix__) || defined(__APPLE__)
+    #include <sys/time.h>
+    #include <signal.h>
+#endif
+
+#if defined(__linux__)
+    #include <time.h>
+    #include <unistd.h>
+    #include <sys/syscall.h>
+
+    // Not defined by older C libraries
+    #if !defined(sigev_notify_thread_id)
+        #define sigev_notify_thread_id _sigev_un._tid
+    #endif
+#endif
+
+namespace profiler {
+    static std::mutex g_names_mutex;
+    static std::vector<std::string> g_names {"<script>"};
+    static std::unordered_map<std::string, std::uint32_t> g_ids {{"<script>", 0u}};
+
+    // Lock-free, so that the signal handler can read it; interpreters on other threads may try to start samplers too
+    static std::atomic<Sampler*> g_active {nullptr};
+
+#if defined(__linux__)
+    // Measures the CPU time of the thread that started the sampler and signals only that thread, so that tasks on
+    // other threads neither count as its time nor run the handler; elsewhere the timer is the process-wide one
+    static timer_t g_timer {};
+#endif
+
+    static std::string callable_name(const std::shared_ptr<object::Object>& callable) {
+        switch (callable->type) {
+            case object::Type::BuiltinFunction:
+                return object::cast<object::BuiltinFunction>(callable)->name;
+            case object::Type::Function:
+                return object::cast<object::Function>(callable)->name.get_lexeme();
+            case object::Type::Method: {
+                auto method {object::cast<object::Method>(callable)};
+                auto instance {object::cast<object::StructInstance>(method->instance)};
+
+                if (instance == nullptr) {
+                    return method->name.get_lexeme();
+                }
+
+                return instance->struct_->name + '.' + method->name.get_lexeme();
+            }
+            case object::Type::Struct:
+                return object::cast<object::Struct>(callable)->name;
+            default:
+                break;
+        }
+
+        assert(false);
+        return {};
+    }
+
+    std::uint32_t function_id(const std::shared_ptr<object::Object>& callable) {
+        object::Callable* object {object::as_callable(callable)};
+
+        if (object->profile_id != 0u) {
+            return object->profile_id;
+        }
+
+        const std::string name {callable_name(callable)};
+
+        std::lock_guard<std::mutex> lock {g_names_mutex};
+
+        const auto iter {g_ids.find(name)};
+
+        if (iter != g_ids.cend()) {
+            object->profile_id = iter->second;
+        } else {
+            object->profile_id = static_cast<std::uint32_t>(g_names.size());
+            g_names.push_back(name);
+            g_ids[name] = object->profile_id;
+        }
+
+        return object->profile_id;
+    }
+
+    std::string function_name(std::uint32_t id) {
+        std::lock_guard<std::mutex> lock {g_names_mutex};
+
+        return g_names.at(id);
+    }
+
+    Sampler::Sampler()
+        : buffer(std::make_unique<std::uint32_t[]>(BUFFER_SIZE)) {}
+
+    Sampler::~Sampler() noexcept {
+        stop();
+    }
+
+    bool Sampler::start(unsigned int interval) {
+#if defined(__unix__) || defined(__APPLE__)
+        // Only one sampler can own the process-wide timer
+        Sampler* expected {nullptr};
+
+        if (!g_active.compare_exchange_strong(expected, this)) {
+            return false;
+        }
+
+        this->interval = interval;
+
+        struct sigaction action {};
+        action.sa_handler = handle_signal;
+        action.sa_flags = SA_RESTART;
+        sigemptyset(&action.sa_mask);
+
+        if (sigaction(SIGPROF, &action, nullptr) != 0) {
+            g_active = nullptr;
+            return false;
+        }
+
+#if defined(__linux__)
+        sigevent event {};
+        event.sigev_notify = SIGEV_THREAD_ID;
+        event.sigev_signo = SIGPROF;
+        event.sigev_notify_thread_id = static_cast<pid_t>(syscall(SYS_gettid));
+
+        if (timer_create(CLOCK_THREAD_CPUTIME_ID, &event, &g_timer) != 0) {
+            g_active = nullptr;
+            return false;
+        }
+
+        itimerspec timer {};
+        timer.it_interval.tv_sec = static_cast<time_t>(interval / 1000000u);
+        timer.it_interval.tv_nsec = static_cast<long>(interval % 1000000u) * 1000l;
+        timer.it_value = timer.it_interval;
+
+        if (timer_settime(g_timer, 0, &timer, nullptr) != 0) {
+            timer_delete(g_timer);
+            g_active = nullptr;
+            return false;
+        }
+#else
+        itimerval timer {};
+        timer.it_interval.tv_sec = static_cast<time_t>(interval / 1000000u);
+        timer.it_interval.tv_usec = static_cast<suseconds_t>(interval % 1000000u);
+        timer.it_value = timer.it_interval;
+
+        if (setitimer(ITIMER_PROF, &timer, nullptr) != 0) {
+            g_active = nullptr;
+            return false;
+        }
+#endif
+
+        running = true;
+
+        return true;
+#else
+        static_cast<void>(interval);
+
+        return false;
+#endif
+    }
+
+    void Sampler::stop() {
+#if defined(__unix__) || defined(__APPLE__)
+        if (!running) {
+            return;
+        }
+
+#if defined(__linux__)
+        timer_delete(g_timer);
+#else
+        itimerval timer {};
+        setitimer(ITIMER_PROF, &timer, nullptr);
+#endif
+
+        signal(SIGPROF, SIG_IGN);
+
+        g_active = nullptr;
+        running = false;
+#endif
+    }
+
+    void Sampler::handle_signal(int) {
+        Sampler* active {g_active.load()};
+
+        if (active != nullptr) {
+            active->sample();
+        }
+    }
+
+    void Sampler::sample() {
+        // Must be async-signal-safe: no allocations, no locks
+        std::atomic_signal_fence(std::memory_order_acquire);
+
+        const std::size_t frames {std::min<std::size_t>(std::size_t(depth), MAX_DEPTH - 1u) + 1u};
+        const std::size_t size {1u + frames * 2u};
+
+        if (buffer_size + size > BUFFER_SIZE) {
+            dropped = dropped + 1u;
+            return;
+        }
+
+        std::uint32_t* record {buffer.get() + buffer_size};
+        record[0u] = static_cast<std::uint32_t>(frames);
+
+        for (std::size_t i {0u}; i < frames; i++) {
+            record[1u + i * 2u] = functions[i];
+            record[2u + i * 2u] = lines[i];
+        }
+
+        buffer_size = buffer_size + size;
+        samples = samples + 1u;
+    }
+
+    template<typename F>
+    void Sampler::for_each_sample(F&& function) const {
+        std::size_t i {0u};
+
+        while (i < buffer_size) {
+            const std::size_t frames {buffer[i]};
+
+            function(buffer.get() + i + 1u, frames);
+
+            i += 1u + frames * 2u;
+        }
+    }
+
+    void Sampler::report(std::ostream& stream) const {
+        std::map<std::uint32_t, std::size_t> self;
+        std::map<std::uint32_t, std::size_t> total;
+        std::map<std::pair<std::uint32_t, std::uint32_t>, std::size_t> self_lines;
+
+        for_each_sample([&](const std::uint32_t* record, std::size_t frames) {
+            const std::uint32_t* innermost {record + (frames - 1u) * 2u};
+
+            self[innermost[0u]]++;
+            self_lines[{innermost[0u], innermost[1u]}]++;
+
+            // Count recursive functions only once per sample
+            std::vector<std::uint32_t> seen;
+
+            for (std::size_t i {0u}; i < frames; i++) {
+                if (std::find(seen.cbegin(), seen.cend(), record[i * 2u]) == seen.cend()) {
+                    seen.push_back(record[i * 2u]);
+                    total[record[i * 2u]]++;
+                }
+            }
+        });
+
+        const double total_samples {static_cast<double>(std::max<std::size_t>(std::size_t(samples), 1u))};
+
+        stream << "il: " << samples << " samples, every " << interval << " us of CPU time";
+
+        if (dropped > 0u) {
+            stream << ", " << dropped << " dropped";
+        }
+
+        stream << "\nil: time spent in spawned tasks is not attributed to their functions\n\n";
+
+        // Every function on any sampled stack, so that callers without samples of their own show their total too
+        std::vector<std::uint32_t> functions_sorted;
+
+        for (const auto& [id, _] : total) {
+            functions_sorted.push_back(id);
+        }
+
+        std::sort(functions_sorted.begin(), functions_sorted.end(), [&](std::uint32_t left, std::uint32_t right) {
+            if (self[left] != self[right]) {
+                return self[left] > self[right];
+            }
+
+            if (total[left] != total[right]) {
+                return total[left] > total[right];
+            }
+
+            return left < right;
+        });
+
+        stream << std::fixed << std::setprecision(2);
+        stream << "     self%    total%  function\n";
+
+        for (const std::uint32_t id : functions_sorted) {
+            stream << std::setw(9) << static_cast<double>(self[id]) * 100.0 / total_samples << '%'
+                << std::setw(9) << static_cast<double>(total[id]) * 100.0 / total_samples << '%'
+                << "  " << function_name(id) << '\n';
+        }
+
+        std::vector<std::pair<std::pair<std::uint32_t, std::uint32_t>, std::size_t>> lines_sorted {
+            self_lines.cbegin(), self_lines.cend()
+        };
+
+        std::sort(lines_sorted.begin(), lines_sorted.end(), [](const auto& left, const auto& right) {
+            return left.second > right.second;
+        });
+
+        stream << "\n     self%  line\n";
+
+        for (const auto& [location, count] : lines_sorted) {
+            stream << std::setw(9) << static_cast<double>(count) * 100.0 / total_samples << '%'
+                << "  " << function_name(location.first) << ':' << location.second << '\n';
+        }
+    }
+
+    void Sampler::write_folded(std::ostream& stream) const {
+        std::map<std::string, std::size_t> stacks;
+
+        for_each_sample([&](const std::uint32_t* record, std::size_t frames) {
+            std::string stack;
+
+            for (std::size_t i {0u}; i < frames; i++) {
+                if (i > 0u) {
+                    stack += ';';
+                }
+
+                stack += function_name(record[i * 2u]);
+            }
+
+            stacks[stack]++;
+        });
+
+        for (const auto& [stack, count] : stacks) {
+            stream << stack << ' ' << count << '\n';
+        }
+    }
+
+    Tracer::Tracer()
+        : nodes {Node {}}, stack {Activation {}} {}
+
+    void Tracer::start() {
+        start_time = std::chrono::steady_clock::now();
+        start_ticks = ticks();
+
+        stack.front().start = start_ticks;
+    }
+
+    void Tracer::stop() {
+        stop_ticks = ticks();
+        stop_time = std::chrono::steady_clock::now();
+
+        assert(stack.size() == 1u);
+
+        Node& root {nodes.front()};
+        root.calls = 1u;
+        root.total = stop_ticks - start_ticks;
+        root.self = root.total - stack.front().children;
+    }
+
+    double Tracer::nanoseconds(std::uint64_t ticks) const {
+        const auto duration {std::chrono::duration<double, std::nano>(stop_time - start_time).count()};
+
+        if (stop_ticks == start_ticks) {
+            return 0.0;
+        }
+
+        return static_cast<double>(ticks) * duration / static_cast<double>(stop_ticks - start_ticks);
+    }
+
+    void Tracer::write_callgrind(std::ostream& stream, const std::string& file_path) const {
+        struct Call {
+            std::uint64_t calls {};
+            std::uint64_t total {};
+        };
+
+        // Merge the nodes of every function and the edges between functions
+        std::map<std::uint32_t, std::uint64_t> self;
+        std::map<std::uint32_t, std::map<std::uint32_t, Call>> calls;
+
+        for (std::size_t i {0u}; i < nodes.size(); i++) {
+            const Node& node {nodes[i]};
+
+            self[node.function] += node.self;
+
+            if (i > 0u) {
+                Call& call {calls[nodes[node.parent].function][node.function]};
+                call.calls += node.calls;
+                call.total += node.total;
+            }
+        }
+
+        const auto cost {[this](std::uint64_t ticks) {
+            return static_cast<std::uint64_t>(nanoseconds(ticks) + 0.5);
+        }};
+
+        stream << "# callgrind format\n"
+            << "version: 1\n"
+            << "creator: il\n"
+            << "cmd: " << file_path << '\n'
+            << "positions: line\n"
+            << "events: Nanoseconds\n"
+            << "summary: " << cost(nodes.front().total) << "\n\n"
+            << "fl=" << file_path << '\n';
+
+        for (const auto& [function, self_ticks] : self) {
+            stream << "\nfn=" << function_name(function) << '\n'
+                << "0 " << cost(self_ticks) << '\n';
+
+            const auto iter {calls.find(function)};
+
+            if (iter == calls.cend()) {
+                continue;
+            }
+
+            for (const auto& [callee, call] : iter->second) {
+                stream << "cfn=" << function_name(callee) << '\n'
+                    << "calls=" << call.calls << " 0\n"
+                    << "0 " << cost(call.total) << '\n';
+            }
+        }
+    }
+
+    void Tracer::write_folded(std::ostream& stream) const {
+        std::map<std::string, std::uint64_t> stacks;
+
+        for (const Node& node : nodes) {
+            std::string stack {function_name(node.function)};
+
+            for (const Node* parent {&node}; parent != &nodes.front(); ) {
+                parent = &nodes[parent->parent];
+                stack = function_name(parent->function) + ';' + stack;
+            }
+
+            stacks[stack] += static_cast<std::uint64_t>(nanoseconds(node.self) + 0.5);
+        }
+
+        for (const auto& [stack, time] : stacks) {
+            if (time > 0u) {
+                stream << stack << ' ' << time << '\n';
+            }
+        }
+    }
+}
@@ -0,0 +1,224 @@
+#pragma once
+
+#include <string>
+#include <memory>
+#include <atomic>
+#include <ostream>
+#include <vector>
+#include <unordered_map>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <csignal>
+
+#if defined(__x86_64__) || defined(__i386__)
+    #include <x86intrin.h>
+#elif defined(_M_X64) || defined(_M_IX86)
+    #include <intrin.h>
+#endif
+
+#include "object.hpp"
+
+// Profilers for IL code
+// The interpreter maintains a shadow stack of IL calls and the current line of every frame,
+// which a SIGPROF handler copies into a preallocated buffer at regular intervals of CPU time
+// The tracer instead times every call exactly and builds the call tree
+namespace profiler {
+    // Callables are identified by their interned name, like `factorial` or `Human.say_hi`
+    // The table is shared by all profilers; id zero is the top level of the script
+    std::uint32_t function_id(const std::shared_ptr<object::Object>& callable);
+    std::string function_name(std::uint32_t id);
+
+    class Sampler {
+    public:
+        static constexpr std::size_t MAX_DEPTH {256u};
+        static constexpr std::size_t BUFFER_SIZE {1u << 22u};
+        static constexpr unsigned int DEFAULT_INTERVAL {1000u};  // Microseconds
+
+        Sampler();
+        ~Sampler() noexcept;
+
+        Sampler(const Sampler&) = delete;
+        Sampler& operator=(const Sampler&) = delete;
+        Sampler(Sampler&&) = delete;
+        Sampler& operator=(Sampler&&) = delete;
+
+        bool start(unsigned int interval = DEFAULT_INTERVAL);
+        void stop();
+
+        void enter(const std::shared_ptr<object::Object>& callable) {
+            const std::uint32_t id {function_id(callable)};
+
+            if (depth + 1u < MAX_DEPTH) {
+                functions[depth + 1u] = id;
+                lines[depth + 1u] = 0u;
+            }
+
+            std::atomic_signal_fence(std::memory_order_release);
+            depth = depth + 1u;
+        }
+
+        void leave() {
+            depth = depth - 1u;
+        }
+
+        void set_line(std::size_t line) {
+            if (depth < MAX_DEPTH) {
+                lines[depth] = static_cast<std::uint32_t>(line);
+            }
+        }
+
+        void report(std::ostream& stream) const;
+        void write_folded(std::ostream& stream) const;
+    private:
+        static void handle_signal(int);
+        void sample();
+
+        template<typename F>
+        void for_each_sample(F&& function) const;
+
+        // Written by the interpreter, read by the signal handler
+        std::uint32_t functions[MAX_DEPTH] {};
+        std::uint32_t lines[MAX_DEPTH] {};
+        volatile std::size_t depth {0u};
+
+        // Written by the signal handler; every sample is the depth followed by pairs of function and line
+        std::unique_ptr<std::uint32_t[]> buffer;
+        volatile std::size_t buffer_size {0u};
+        volatile std::size_t samples {0u};
+        volatile std::size_t dropped {0u};
+
+        unsigned int interval {DEFAULT_INTERVAL};
+        bool running {false};
+    };
+
+    // Time stamp counter where available, which is monotonic and invariant on all recent x86 processors
+    inline std::uint64_t ticks() {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+        return __rdtsc();
+#else
+        return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+    }
+
+    // Deterministic profiler that records every call in a call tree
+    class Tracer {
+    public:
+        Tracer();
+
+        void start();
+        void stop();
+
+        void enter(const std::shared_ptr<object::Object>& callable) {
+            const std::uint32_t id {function_id(callable)};
+            const std::size_t parent {stack.back().node};
+
+            std::size_t node {};
+            const auto iter {nodes[parent].children.find(id)};
+
+            if (iter != nodes[parent].children.cend()) {
+                node = iter->second;
+            } else {
+                node = nodes.size();
+                nodes[parent].children[id] = node;
+                nodes.emplace_back();
+                nodes.back().function = id;
+                nodes.back().parent = parent;
+            }
+
+            stack.push_back(Activation {node, ticks(), 0u});
+        }
+
+        void leave() {
+            const Activation activation {stack.back()};
+            stack.pop_back();
+
+            const std::uint64_t elapsed {ticks() - activation.start};
+
+            Node& node {nodes[activation.node]};
+            node.calls++;
+            node.total += elapsed;
+            node.self += elapsed - activation.children;
+
+            stack.back().children += elapsed;
+        }
+
+        // Costs are written in nanoseconds
+        void write_callgrind(std::ostream& stream, const std::string& file_path) const;
+        void write_folded(std::ostream& stream) const;
+    private:
+        // Every distinct call path gets a node; the root is the top level of the script
+        struct Node {
+            std::uint32_t function {};
+            std::size_t parent {};
+            std::uint64_t calls {};
+            std::uint64_t self {};
+            std::uint64_t total {};
+            std::unordered_map<std::uint32_t, std::size_t> children;
+        };
+
+        struct Activation {
+            std::size_t node {};
+            std::uint64_t start {};
+            std::uint64_t children {};  // Time spent in the callees
+        };
+
+        double nanoseconds(std::uint64_t ticks) const;
+
+        std::vector<Node> nodes;
+        std::vector<Activation> stack;
+
+        // For converting ticks to time
+        std::uint64_t start_ticks {};
+        std::uint64_t stop_ticks {};
+        std::chrono::steady_clock::time_point start_time;
+        std::chrono::steady_clock::time_point stop_time;
+    };
+
+    // Shadow stack frame for one call; does nothing when there are no profilers
+    class Frame {
+    public:
+        Frame(Sampler* sampler, Tracer* tracer, const std::shared_ptr<object::Object>& callable)
+            : sampler(sampler), tracer(tracer) {
+            if (sampler != nullptr) {
+                sampler->enter(callable);
+            }
+
+            if (tracer != nullptr) {
+                tracer->enter(callable);
+            }
+        }
+
+        ~Frame() noexcept {
+            if (tracer != nullptr) {
+                tracer->leave();
+            }
+
+            if (sampler != nullptr) {
+                sampler->leave();
+            }
+        }
+
+        Frame(const Frame&) = delete;
+        Frame& operator=(const Frame&) = delete;
+        Frame(Frame&&) = delete;
+        Frame& operator=(Frame&&) = delete;
+    private:
+        Sampler* sampler {nullptr};
+        Tracer* tracer {nullptr};
+    };
+
+    // A tail call leaves the frame of the function making it and the callee takes its place, so that it's recorded
+    // as a call of its own from the same caller; the enclosing Frame then leaves the callee's frame
+    inline void replace(Sampler* sampler, Tracer* tracer, const std::shared_ptr<object::Object>& callable) {
+        if (tracer != nullptr) {
+            tracer->leave();
+            tracer->enter(callable);
+        }
+
+        if (sampler != nullptr) {
+            sampler->leave();
+            sampler->enter(callable);
+        }
+    }
+}
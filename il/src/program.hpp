@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+
+#include "ast.hpp"
+#include "object.hpp"
+
+// A script compiled once, for running it any number of times
+// Running never modifies the statements, so a program can be shared by interpreters on different threads and run by
+// all of them at the same time
+class Program {
+public:
+    using Statements = std::vector<std::shared_ptr<ast::stmt::Stmt<std::shared_ptr<object::Object>>>>;
+
+    Program(Statements&& statements, const std::string& file_path)
+        : statements(std::move(statements)), file_path(file_path) {}
+
+    const Statements& get_statements() const { return statements; }
+    const std::string& get_file_path() const { return file_path; }
+private:
+    const Statements statements;
+    const std::string file_path;
+};
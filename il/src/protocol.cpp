@@ -0,0 +1,216 @@
+#include "protocol.hpp"
+
+#include <cstring>
+#include <cstdint>
+
+#include "numeric.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+    #include <sys/socket.h>
+    #include <sys/un.h>
+    #include <unistd.h>
+    #include <cerrno>
+#endif
+
+namespace protocol {
+#if defined(__unix__) || defined(__APPLE__)
+    static bool write_all(int descriptor, const char* data, std::size_t size) {
+        while (size > 0u) {
+            const ssize_t count {::write(descriptor, data, size)};
+
+            if (count < 0 && errno == EINTR) {
+                continue;
+            }
+
+            if (count <= 0) {
+                return false;
+            }
+
+            data += count;
+            size -= static_cast<std::size_t>(count);
+        }
+
+        return true;
+    }
+
+    static bool read_all(int descriptor, char* data, std::size_t size) {
+        while (size > 0u) {
+            const ssize_t count {::read(descriptor, data, size)};
+
+            if (count < 0 && errno == EINTR) {
+                continue;
+            }
+
+            if (count <= 0) {
+                return false;
+            }
+
+            data += count;
+            size -= static_cast<std::size_t>(count);
+        }
+
+        return true;
+    }
+#endif
+
+    bool write_frame(int descriptor, Frame type, std::string_view payload) {
+#if defined(__unix__) || defined(__APPLE__)
+        if (payload.size() > MAX_PAYLOAD) {
+            return false;
+        }
+
+        const auto size {static_cast<std::uint32_t>(payload.size())};
+
+        const char header[5u] {
+            static_cast<char>(type),
+            static_cast<char>(size >> 24u),
+            static_cast<char>(size >> 16u),
+            static_cast<char>(size >> 8u),
+            static_cast<char>(size)
+        };
+
+        return write_all(descriptor, header, sizeof(header)) && write_all(descriptor, payload.data(), payload.size());
+#else
+        static_cast<void>(descriptor);
+        static_cast<void>(type);
+        static_cast<void>(payload);
+
+        return false;
+#endif
+    }
+
+    bool read_frame(int descriptor, Frame& type, std::string& payload) {
+#if defined(__unix__) || defined(__APPLE__)
+        unsigned char header[5u] {};
+
+        if (!read_all(descriptor, reinterpret_cast<char*>(header), sizeof(header))) {
+            return false;
+        }
+
+        const std::size_t size {
+            static_cast<std::size_t>(header[1u]) << 24u | static_cast<std::size_t>(header[2u]) << 16u
+                | static_cast<std::size_t>(header[3u]) << 8u | static_cast<std::size_t>(header[4u])
+        };
+
+        if (size > MAX_PAYLOAD) {
+            return false;
+        }
+
+        type = static_cast<Frame>(header[0u]);
+        payload.resize(size);
+
+        return read_all(descriptor, payload.data(), size);
+#else
+        static_cast<void>(descriptor);
+        static_cast<void>(type);
+        static_cast<void>(payload);
+
+        return false;
+#endif
+    }
+
+    int connect(const std::string& socket_path) {
+#if defined(__unix__) || defined(__APPLE__)
+        sockaddr_un address {};
+        address.sun_family = AF_UNIX;
+
+        if (socket_path.size() >= sizeof(address.sun_path)) {
+            return -1;
+        }
+
+        std::memcpy(address.sun_path, socket_path.c_str(), socket_path.size() + 1u);
+
+        const int descriptor {::socket(AF_UNIX, SOCK_STREAM, 0)};
+
+        if (descriptor < 0) {
+            return -1;
+        }
+
+        if (::connect(descriptor, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+            ::close(descriptor);
+            return -1;
+        }
+
+        return descriptor;
+#else
+        static_cast<void>(socket_path);
+
+        return -1;
+#endif
+    }
+
+    bool send_request(int descriptor, Frame script_type, const std::string& script, const std::vector<std::string>& arguments) {
+        if (!write_frame(descriptor, script_type, script)) {
+            return false;
+        }
+
+        for (const std::string& argument : arguments) {
+            if (!write_frame(descriptor, Frame::Argument, argument)) {
+                return false;
+            }
+        }
+
+        return write_frame(descriptor, Frame::Run, {});
+    }
+
+    bool read_response(int descriptor, int& status, const std::function<void(Frame, std::string_view)>& written) {
+        Frame type {};
+        std::string payload;
+
+        while (read_frame(descriptor, type, payload)) {
+            switch (type) {
+                case Frame::Output:
+                case Frame::Errors:
+                    written(type, payload);
+                    break;
+                case Frame::Exit: {
+                    long long value {};
+
+                    if (numeric::parse(payload, value) != numeric::Error::None) {
+                        return false;
+                    }
+
+                    status = static_cast<int>(value);
+
+                    return true;
+                }
+                default:
+                    return false;
+            }
+        }
+
+        return false;
+    }
+
+    FrameBuffer::FrameBuffer(Frame type)
+        : buffer(std::make_unique<char[]>(CAPACITY)), type(type) {
+        setp(buffer.get(), buffer.get() + CAPACITY);
+    }
+
+    FrameBuffer::int_type FrameBuffer::overflow(int_type character) {
+        send();
+
+        if (!traits_type::eq_int_type(character, traits_type::eof())) {
+            *pptr() = traits_type::to_char_type(character);
+            pbump(1);
+        }
+
+        return traits_type::not_eof(character);
+    }
+
+    int FrameBuffer::sync() {
+        send();
+
+        return 0;
+    }
+
+    void FrameBuffer::send() {
+        const auto size {static_cast<std::size_t>(pptr() - pbase())};
+
+        if (size > 0u && descriptor >= 0 && !write_frame(descriptor, type, std::string_view(pbase(), size))) {
+            descriptor = -1;
+        }
+
+        setp(buffer.get(), buffer.get() + CAPACITY);
+    }
+}
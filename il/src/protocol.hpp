@@ -0,0 +1,59 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <functional>
+#include <streambuf>
+#include <memory>
+#include <cstddef>
+
+// The messages between `il --serve` and its clients over a Unix domain socket, on POSIX systems only
+// A message is a sequence of frames, each a type byte, a 32-bit big-endian length and that many bytes
+// Requests are a File or a Source frame, any number of Argument frames and a Run frame; the server answers with
+// Output and Errors frames as the script writes, then an Exit frame with the exit status in decimal
+// Connections may carry any number of requests, one after the other
+namespace protocol {
+    enum class Frame : char {
+        File = 'F',
+        Source = 'S',
+        Argument = 'A',
+        Run = 'R',
+        Output = 'O',
+        Errors = 'E',
+        Exit = 'X'
+    };
+
+    inline constexpr std::size_t MAX_PAYLOAD {64u * 1024u * 1024u};
+
+    // Both return false on errors, the other side closing or a payload that is too large
+    bool write_frame(int descriptor, Frame type, std::string_view payload);
+    bool read_frame(int descriptor, Frame& type, std::string& payload);
+
+    // A connected socket; negative on errors
+    int connect(const std::string& socket_path);
+
+    // The client's side of a request; output and errors are handed over as they arrive
+    bool send_request(int descriptor, Frame script_type, const std::string& script, const std::vector<std::string>& arguments);
+    bool read_response(int descriptor, int& status, const std::function<void(Frame, std::string_view)>& written);
+
+    // Sends everything written to it as frames of one type, when its buffer fills up or when flushed
+    class FrameBuffer : public std::streambuf {
+    public:
+        static constexpr std::size_t CAPACITY {65536u};
+
+        explicit FrameBuffer(Frame type);
+
+        // Negative to write nowhere; writing fails quietly once the client is gone
+        void set_descriptor(int descriptor) { this->descriptor = descriptor; }
+    protected:
+        int_type overflow(int_type character) override;
+        int sync() override;
+    private:
+        void send();
+
+        std::unique_ptr<char[]> buffer;
+        Frame type;
+        int descriptor {-1};
+    };
+}
@@ -1,12 +1,18 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include "object.hpp"
+#include "token.hpp"
 
+// Pending return from a function, set by the return statement and picked up by the function being returned from
+// The statements in between stop executing as soon as they see it
 struct Return {
-    explicit Return(std::shared_ptr<object::Object> value)
-        : value(value) {}
-
     std::shared_ptr<object::Object> value;
+
+    // Tail call, which the function makes in place of its own frame
+    std::shared_ptr<object::Object> callee;  // Null for a plain return
+    std::vector<std::shared_ptr<object::Object>> arguments;
+    const token::Token* token {nullptr};
 };
@@ -1,10 +1,11 @@
 #include "scanner.hpp"
 
-#include <stdexcept>
 #include <cassert>
 #include <utility>
 #include <unordered_map>
 
+#include "numeric.hpp"
+
 std::vector<token::Token> Scanner::scan() {
     while (!reached_end()) {
         // Beginning of the next lexeme
@@ -36,6 +37,12 @@ void Scanner::scan_token() {
         case '}':
             add_token(token::TokenType::RightBrace);
             break;
+        case '[':
+            add_token(token::TokenType::LeftBracket);
+            break;
+        case ']':
+            add_token(token::TokenType::RightBracket);
+            break;
         case ',':
             add_token(token::TokenType::Comma);
             break;
@@ -45,6 +52,9 @@ void Scanner::scan_token() {
         case ';':
             add_token(token::TokenType::Semicolon);
             break;
+        case ':':
+            add_token(token::TokenType::Colon);
+            break;
         case '-':
             add_token(token::TokenType::Minus);
             break;
@@ -225,10 +235,12 @@ void Scanner::number() {
         }
     }
 
+    const std::string_view lexeme {std::string_view(source_code).substr(start, current - start)};
+
     if (floating_point) {
-        add_token(token::TokenType::Float, parse_double(source_code.substr(start, current - start)));
+        add_token(token::TokenType::Float, parse_double(lexeme));
     } else {
-        add_token(token::TokenType::Integer, parse_long_long(source_code.substr(start, current - start)));
+        add_token(token::TokenType::Integer, parse_long_long(lexeme));
     }
 }
 
@@ -251,7 +263,9 @@ void Scanner::identifier() {
         { "for", token::TokenType::For },
         { "fun", token::TokenType::Fun },
         { "return", token::TokenType::Return },
-        { "struct", token::TokenType::Struct }
+        { "struct", token::TokenType::Struct },
+        { "memo", token::TokenType::Memo },
+        { "in", token::TokenType::In }
     };
 
     const auto word {source_code.substr(start, current - start)};
@@ -264,31 +278,35 @@ void Scanner::identifier() {
     add_token(token::TokenType::Identifier);
 }
 
-long long Scanner::parse_long_long(const std::string& string) {
+long long Scanner::parse_long_long(std::string_view string) {
     long long result {};
 
-    try {
-        result = std::stoll(string);
-    } catch (const std::invalid_argument&) {
-        assert(false);
-    } catch (const std::out_of_range&) {
-        ctx->error(line, "Integer value out of range");
-        return 0ll;
+    switch (numeric::parse(string, result)) {
+        case numeric::Error::None:
+            break;
+        case numeric::Error::Invalid:
+            assert(false);
+            break;
+        case numeric::Error::OutOfRange:
+            ctx->error(line, "Integer value out of range");
+            return 0ll;
     }
 
     return result;
 }
 
-double Scanner::parse_double(const std::string& string) {
+double Scanner::parse_double(std::string_view string) {
     double result {};
 
-    try {
-        result = std::stod(string);
-    } catch (const std::invalid_argument&) {
-        assert(false);
-    } catch (const std::out_of_range&) {
-        ctx->error(line, "Float value out of range");
-        return 0.0;
+    switch (numeric::parse(string, result)) {
+        case numeric::Error::None:
+            break;
+        case numeric::Error::Invalid:
+            assert(false);
+            break;
+        case numeric::Error::OutOfRange:
+            ctx->error(line, "Float value out of range");
+            return 0.0;
     }
 
     return result;
@@ -2,7 +2,9 @@
 
 #include <vector>
 #include <string>
+#include <string_view>
 #include <cstddef>
+#include <utility>
 
 #include "token.hpp"
 #include "context.hpp"
@@ -12,6 +14,10 @@ public:
     Scanner(const std::string& source_code, Context* ctx)
         : source_code(source_code), ctx(ctx) {}
 
+    // A piece of a larger source, starting at the given line
+    Scanner(std::string&& source_code, Context* ctx, std::size_t line)
+        : source_code(std::move(source_code)), line(line), ctx(ctx) {}
+
     std::vector<token::Token> scan();
 private:
     void scan_token();
@@ -30,8 +36,8 @@ private:
     void string();
     void number();
     void identifier();
-    long long parse_long_long(const std::string& string);
-    double parse_double(const std::string& string);
+    long long parse_long_long(std::string_view string);
+    double parse_double(std::string_view string);
 
     std::string source_code;
     std::vector<token::Token> tokens;
@@ -0,0 +1,795 @@
+#include "serialization.hpp"
+
+#include <cstring>
+#include <utility>
+
+#include "lazy.hpp"
+#include "runtime_error.hpp"
+
+namespace serialization {
+    enum class Node : std::uint8_t {
+        Null,
+
+        // Expressions
+        Literal, Grouping, Unary, Binary, Variable, Assignment, Logical, Call, Get, Set, Array, Index, IndexSet, MapLiteral, SetLiteral,
+
+        // Statements
+        Expression, Let, Function, Struct, If, While, ForRange, Block, Return
+    };
+
+    class AstWriter : ast::expr::Visitor<std::shared_ptr<object::Object>>, ast::stmt::Visitor<std::shared_ptr<object::Object>> {
+    public:
+        explicit AstWriter(Writer* writer)
+            : writer(writer) {}
+
+        void write(const std::shared_ptr<ast::expr::Expr<std::shared_ptr<object::Object>>>& expr);
+        void write(const std::shared_ptr<ast::stmt::Stmt<std::shared_ptr<object::Object>>>& stmt);
+        void write(const std::vector<std::shared_ptr<ast::stmt::Stmt<std::shared_ptr<object::Object>>>>& stmts);
+        void write(const std::vector<std::shared_ptr<ast::expr::Expr<std::shared_ptr<object::Object>>>>& exprs);
+        void write_function(const ast::stmt::Function<std::shared_ptr<object::Object>>* stmt);
+    private:
+        void tag(Node node);
+
+        std::shared_ptr<object::Object> visit(ast::expr::Literal<std::shared_ptr<object::Object>>* expr) override;
+        std::shared_ptr<object::Object> visit(ast::expr::Grouping<std::shared_ptr<object::Object>>* expr) override;
+        std::shared_ptr<object::Object> visit(ast::expr::Unary<std::shared_ptr<object::Object>>* expr) override;
+        std::shared_ptr<object::Object> visit(ast::expr::Binary<std::shared_ptr<object::Object>>* expr) override;
+        std::shared_ptr<object::Object> visit(ast::expr::Variable<std::shared_ptr<object::Object>>* expr) override;
+        std::shared_ptr<object::Object> visit(ast::expr::Assignment<std::shared_ptr<object::Object>>* expr) override;
+        std::shared_ptr<object::Object> visit(ast::expr::Logical<std::shared_ptr<object::Object>>* expr) override;
+        std::shared_ptr<object::Object> visit(ast::expr::Call<std::shared_ptr<object::Object>>* expr) override;
+        std::shared_ptr<object::Object> visit(ast::expr::Get<std::shared_ptr<object::Object>>* expr) override;
+        std::shared_ptr<object::Object> visit(ast::expr::Set<std::shared_ptr<object::Object>>* expr) override;
+        std::shared_ptr<object::Object> visit(ast::expr::Array<std::shared_ptr<object::Object>>* expr) override;
+        std::shared_ptr<object::Object> visit(ast::expr::Index<std::shared_ptr<object::Object>>* expr) override;
+        std::shared_ptr<object::Object> visit(ast::expr::IndexSet<std::shared_ptr<object::Object>>* expr) override;
+        std::shared_ptr<object::Object> visit(ast::expr::MapLiteral<std::shared_ptr<object::Object>>* expr) override;
+        std::shared_ptr<object::Object> visit(ast::expr::SetLiteral<std::shared_ptr<object::Object>>* expr) override;
+
+        std::shared_ptr<object::Object> visit(const ast::stmt::Expression<std::shared_ptr<object::Object>>* stmt) override;
+        std::shared_ptr<object::Object> visit(const ast::stmt::Let<std::shared_ptr<object::Object>>* stmt) override;
+        std::shared_ptr<object::Object> visit(const ast::stmt::Function<std::shared_ptr<object::Object>>* stmt) override;
+        std::shared_ptr<object::Object> visit(const ast::stmt::Struct<std::shared_ptr<object::Object>>* stmt) override;
+        std::shared_ptr<object::Object> visit(const ast::stmt::If<std::shared_ptr<object::Object>>* stmt) override;
+        std::shared_ptr<object::Object> visit(const ast::stmt::While<std::shared_ptr<object::Object>>* stmt) override;
+        std::shared_ptr<object::Object> visit(const ast::stmt::ForRange<std::shared_ptr<object::Object>>* stmt) override;
+        std::shared_ptr<object::Object> visit(const ast::stmt::Block<std::shared_ptr<object::Object>>* stmt) override;
+        std::shared_ptr<object::Object> visit(const ast::stmt::Return<std::shared_ptr<object::Object>>* stmt) override;
+
+        Writer* writer {nullptr};
+    };
+
+    class AstReader {
+    public:
+        explicit AstReader(Reader* reader)
+            : reader(reader) {}
+
+        std::shared_ptr<ast::expr::Expr<std::shared_ptr<object::Object>>> read_expr();
+        std::shared_ptr<ast::stmt::Stmt<std::shared_ptr<object::Object>>> read_stmt();
+        std::vector<std::shared_ptr<ast::stmt::Stmt<std::shared_ptr<object::Object>>>> read_stmts();
+        std::vector<std::shared_ptr<ast::expr::Expr<std::shared_ptr<object::Object>>>> read_exprs();
+        std::shared_ptr<ast::stmt::Function<std::shared_ptr<object::Object>>> read_function();
+        std::vector<token::Token> read_tokens();
+    private:
+        std::shared_ptr<ast::stmt::Stmt<std::shared_ptr<object::Object>>> read_stmt_node();
+        std::size_t read_size();
+
+        Reader* reader {nullptr};
+    };
+
+    void Writer::write_u8(std::uint8_t value) {
+        data.push_back(static_cast<char>(value));
+    }
+
+    void Writer::write_u64(std::uint64_t value) {
+        while (value >= 0x80u) {
+            write_u8(static_cast<std::uint8_t>(value | 0x80u));
+            value >>= 7u;
+        }
+
+        write_u8(static_cast<std::uint8_t>(value));
+    }
+
+    void Writer::write_i64(std::int64_t value) {
+        // Zigzag encoding keeps small negative numbers small
+        write_u64((static_cast<std::uint64_t>(value) << 1u) ^ static_cast<std::uint64_t>(value >> 63));
+    }
+
+    void Writer::write_f64(double value) {
+        std::uint64_t bits {};
+        std::memcpy(&bits, &value, sizeof(bits));
+
+        for (unsigned int i {0u}; i < 8u; i++) {
+            write_u8(static_cast<std::uint8_t>(bits >> (i * 8u)));
+        }
+    }
+
+    void Writer::write_string(std::string_view value) {
+        write_u64(value.size());
+        data.append(value);
+    }
+
+    void Writer::write_token(const token::Token& token) {
+        write_u8(static_cast<std::uint8_t>(token.get_type()));
+        write_u64(token.get_line());
+        write_string(token.get_lexeme());
+
+        const token::Token::Literal& literal {token.get_literal()};
+
+        write_u8(static_cast<std::uint8_t>(literal.index()));
+
+        switch (literal.index()) {
+            case 1u:
+                write_string(std::get<1u>(literal));
+                break;
+            case 2u:
+                write_i64(std::get<2u>(literal));
+                break;
+            case 3u:
+                write_f64(std::get<3u>(literal));
+                break;
+            default:
+                break;
+        }
+    }
+
+    void Writer::write_literal(const std::shared_ptr<object::Object>& value) {
+        write_u8(static_cast<std::uint8_t>(value->type));
+
+        switch (value->type) {
+            case object::Type::None:
+                break;
+            case object::Type::String:
+                write_string(object::cast<object::String>(value)->value);
+                break;
+            case object::Type::Integer:
+                write_i64(object::cast<object::Integer>(value)->value);
+                break;
+            case object::Type::Float:
+                write_f64(object::cast<object::Float>(value)->value);
+                break;
+            case object::Type::Boolean:
+                write_u8(object::cast<object::Boolean>(value)->value);
+                break;
+            default:
+                // Other objects never appear as literals
+                throw Error();
+        }
+    }
+
+    std::uint8_t Reader::read_u8() {
+        if (current == data.size()) {
+            throw Error();
+        }
+
+        return static_cast<std::uint8_t>(data[current++]);
+    }
+
+    std::uint64_t Reader::read_u64() {
+        std::uint64_t value {};
+
+        for (unsigned int shift {0u}; shift < 64u; shift += 7u) {
+            const std::uint8_t byte {read_u8()};
+
+            value |= static_cast<std::uint64_t>(byte & 0x7Fu) << shift;
+
+            if ((byte & 0x80u) == 0u) {
+                return value;
+            }
+        }
+
+        throw Error();
+    }
+
+    std::int64_t Reader::read_i64() {
+        const std::uint64_t value {read_u64()};
+
+        return static_cast<std::int64_t>(value >> 1u) ^ -static_cast<std::int64_t>(value & 1u);
+    }
+
+    double Reader::read_f64() {
+        std::uint64_t bits {};
+
+        for (unsigned int i {0u}; i < 8u; i++) {
+            bits |= static_cast<std::uint64_t>(read_u8()) << (i * 8u);
+        }
+
+        double value {};
+        std::memcpy(&value, &bits, sizeof(value));
+
+        return value;
+    }
+
+    std::string Reader::read_string() {
+        const std::uint64_t size {read_u64()};
+
+        if (size > data.size() - current) {
+            throw Error();
+        }
+
+        std::string value {data.substr(current, static_cast<std::size_t>(size))};
+        current += static_cast<std::size_t>(size);
+
+        return value;
+    }
+
+    token::Token Reader::read_token() {
+        const std::uint8_t type_index {read_u8()};
+
+        if (type_index >= static_cast<std::uint8_t>(token::TokenType::TokenCount)) {
+            throw Error();
+        }
+
+        const auto type {static_cast<token::TokenType>(type_index)};
+        const auto line {static_cast<std::size_t>(read_u64())};
+        const std::string lexeme {read_string()};
+
+        switch (read_u8()) {
+            case 0u:
+                return token::Token(type, lexeme, line);
+            case 1u:
+                if (type != token::TokenType::String) {
+                    throw Error();
+                }
+
+                return token::Token(type, lexeme, line, read_string());
+            case 2u:
+                if (type != token::TokenType::Integer) {
+                    throw Error();
+                }
+
+                return token::Token(type, lexeme, line, static_cast<long long>(read_i64()));
+            case 3u:
+                if (type != token::TokenType::Float) {
+                    throw Error();
+                }
+
+                return token::Token(type, lexeme, line, read_f64());
+            default:
+                throw Error();
+        }
+    }
+
+    std::shared_ptr<object::Object> Reader::read_literal() {
+        switch (static_cast<object::Type>(read_u8())) {
+            case object::Type::None:
+                return object::create_none();
+            case object::Type::String:
+                return object::create_string(read_string());
+            case object::Type::Integer:
+                return object::create_integer(static_cast<long long>(read_i64()));
+            case object::Type::Float:
+                return object::create_float(read_f64());
+            case object::Type::Boolean:
+                return object::create_bool(read_u8() != 0u);
+            default:
+                throw Error();
+        }
+    }
+
+    void AstWriter::write(const std::shared_ptr<ast::expr::Expr<std::shared_ptr<object::Object>>>& expr) {
+        if (expr == nullptr) {
+            tag(Node::Null);
+            return;
+        }
+
+        expr->accept(this);
+    }
+
+    void AstWriter::write(const std::shared_ptr<ast::stmt::Stmt<std::shared_ptr<object::Object>>>& stmt) {
+        if (stmt == nullptr) {
+            tag(Node::Null);
+            return;
+        }
+
+        stmt->accept(this);
+        writer->write_u64(stmt->line);
+    }
+
+    void AstWriter::write(const std::vector<std::shared_ptr<ast::stmt::Stmt<std::shared_ptr<object::Object>>>>& stmts) {
+        writer->write_u64(stmts.size());
+
+        for (const auto& stmt : stmts) {
+            write(stmt);
+        }
+    }
+
+    void AstWriter::write(const std::vector<std::shared_ptr<ast::expr::Expr<std::shared_ptr<object::Object>>>>& exprs) {
+        writer->write_u64(exprs.size());
+
+        for (const auto& expr : exprs) {
+            write(expr);
+        }
+    }
+
+    void AstWriter::write_function(const ast::stmt::Function<std::shared_ptr<object::Object>>* stmt) {
+        writer->write_token(stmt->name);
+        writer->write_u64(stmt->parameters.size());
+
+        for (const token::Token& parameter : stmt->parameters) {
+            writer->write_token(parameter);
+        }
+
+        // Lazy bodies are compiled first; the ones that don't compile can't be stored
+        try {
+            write(lazy::body(*stmt));
+        } catch (const RuntimeError&) {
+            throw Error();
+        }
+
+        writer->write_u8(stmt->memoized ? 1u : 0u);
+    }
+
+    void AstWriter::tag(Node node) {
+        writer->write_u8(static_cast<std::uint8_t>(node));
+    }
+
+    std::shared_ptr<object::Object> AstWriter::visit(ast::expr::Literal<std::shared_ptr<object::Object>>* expr) {
+        tag(Node::Literal);
+        writer->write_literal(expr->value);
+
+        return nullptr;
+    }
+
+    std::shared_ptr<object::Object> AstWriter::visit(ast::expr::Grouping<std::shared_ptr<object::Object>>* expr) {
+        tag(Node::Grouping);
+        write(expr->expression);
+
+        return nullptr;
+    }
+
+    std::shared_ptr<object::Object> AstWriter::visit(ast::expr::Unary<std::shared_ptr<object::Object>>* expr) {
+        tag(Node::Unary);
+        writer->write_token(expr->operator_);
+        write(expr->right);
+
+        return nullptr;
+    }
+
+    std::shared_ptr<object::Object> AstWriter::visit(ast::expr::Binary<std::shared_ptr<object::Object>>* expr) {
+        tag(Node::Binary);
+        write(expr->left);
+        writer->write_token(expr->operator_);
+        write(expr->right);
+
+        return nullptr;
+    }
+
+    std::shared_ptr<object::Object> AstWriter::visit(ast::expr::Variable<std::shared_ptr<object::Object>>* expr) {
+        tag(Node::Variable);
+        writer->write_token(expr->name);
+
+        return nullptr;
+    }
+
+    std::shared_ptr<object::Object> AstWriter::visit(ast::expr::Assignment<std::shared_ptr<object::Object>>* expr) {
+        tag(Node::Assignment);
+        writer->write_token(expr->name);
+        write(expr->value);
+
+        return nullptr;
+    }
+
+    std::shared_ptr<object::Object> AstWriter::visit(ast::expr::Logical<std::shared_ptr<object::Object>>* expr) {
+        tag(Node::Logical);
+        write(expr->left);
+        writer->write_token(expr->operator_);
+        write(expr->right);
+
+        return nullptr;
+    }
+
+    std::shared_ptr<object::Object> AstWriter::visit(ast::expr::Call<std::shared_ptr<object::Object>>* expr) {
+        tag(Node::Call);
+        write(expr->callee);
+        writer->write_token(expr->paren);
+        write(expr->arguments);
+
+        return nullptr;
+    }
+
+    std::shared_ptr<object::Object> AstWriter::visit(ast::expr::Get<std::shared_ptr<object::Object>>* expr) {
+        tag(Node::Get);
+        write(expr->object);
+        writer->write_token(expr->name);
+
+        return nullptr;
+    }
+
+    std::shared_ptr<object::Object> AstWriter::visit(ast::expr::Set<std::shared_ptr<object::Object>>* expr) {
+        tag(Node::Set);
+        write(expr->object);
+        writer->write_token(expr->name);
+        write(expr->value);
+
+        return nullptr;
+    }
+
+    std::shared_ptr<object::Object> AstWriter::visit(ast::expr::Array<std::shared_ptr<object::Object>>* expr) {
+        tag(Node::Array);
+        writer->write_token(expr->bracket);
+        write(expr->elements);
+
+        return nullptr;
+    }
+
+    std::shared_ptr<object::Object> AstWriter::visit(ast::expr::Index<std::shared_ptr<object::Object>>* expr) {
+        tag(Node::Index);
+        write(expr->object);
+        writer->write_token(expr->bracket);
+        write(expr->index);
+
+        return nullptr;
+    }
+
+    std::shared_ptr<object::Object> AstWriter::visit(ast::expr::IndexSet<std::shared_ptr<object::Object>>* expr) {
+        tag(Node::IndexSet);
+        write(expr->object);
+        writer->write_token(expr->bracket);
+        write(expr->index);
+        write(expr->value);
+
+        return nullptr;
+    }
+
+    std::shared_ptr<object::Object> AstWriter::visit(ast::expr::MapLiteral<std::shared_ptr<object::Object>>* expr) {
+        tag(Node::MapLiteral);
+        writer->write_token(expr->brace);
+        write(expr->keys);
+        write(expr->values);
+
+        return nullptr;
+    }
+
+    std::shared_ptr<object::Object> AstWriter::visit(ast::expr::SetLiteral<std::shared_ptr<object::Object>>* expr) {
+        tag(Node::SetLiteral);
+        writer->write_token(expr->brace);
+        write(expr->elements);
+
+        return nullptr;
+    }
+
+    std::shared_ptr<object::Object> AstWriter::visit(const ast::stmt::Expression<std::shared_ptr<object::Object>>* stmt) {
+        tag(Node::Expression);
+        write(stmt->expression);
+
+        return nullptr;
+    }
+
+    std::shared_ptr<object::Object> AstWriter::visit(const ast::stmt::Let<std::shared_ptr<object::Object>>* stmt) {
+        tag(Node::Let);
+        writer->write_token(stmt->name);
+        write(stmt->initializer);
+
+        return nullptr;
+    }
+
+    std::shared_ptr<object::Object> AstWriter::visit(const ast::stmt::Function<std::shared_ptr<object::Object>>* stmt) {
+        tag(Node::Function);
+        write_function(stmt);
+
+        return nullptr;
+    }
+
+    std::shared_ptr<object::Object> AstWriter::visit(const ast::stmt::Struct<std::shared_ptr<object::Object>>* stmt) {
+        tag(Node::Struct);
+        writer->write_token(stmt->name);
+        writer->write_u64(stmt->methods.size());
+
+        for (const auto& method : stmt->methods) {
+            write_function(method.get());
+            writer->write_u64(method->line);
+        }
+
+        return nullptr;
+    }
+
+    std::shared_ptr<object::Object> AstWriter::visit(const ast::stmt::If<std::shared_ptr<object::Object>>* stmt) {
+        tag(Node::If);
+        write(stmt->condition);
+        write(stmt->then_branch);
+        write(stmt->else_branch);
+        writer->write_token(stmt->paren);
+
+        return nullptr;
+    }
+
+    std::shared_ptr<object::Object> AstWriter::visit(const ast::stmt::While<std::shared_ptr<object::Object>>* stmt) {
+        tag(Node::While);
+        write(stmt->condition);
+        write(stmt->body);
+        writer->write_token(stmt->paren);
+
+        return nullptr;
+    }
+
+    std::shared_ptr<object::Object> AstWriter::visit(const ast::stmt::ForRange<std::shared_ptr<object::Object>>* stmt) {
+        tag(Node::ForRange);
+        writer->write_token(stmt->name);
+        writer->write_token(stmt->range);
+        write(stmt->start);
+        write(stmt->stop);
+        write(stmt->step);
+        write(stmt->body);
+
+        return nullptr;
+    }
+
+    std::shared_ptr<object::Object> AstWriter::visit(const ast::stmt::Block<std::shared_ptr<object::Object>>* stmt) {
+        tag(Node::Block);
+        write(stmt->statements);
+
+        return nullptr;
+    }
+
+    std::shared_ptr<object::Object> AstWriter::visit(const ast::stmt::Return<std::shared_ptr<object::Object>>* stmt) {
+        tag(Node::Return);
+        writer->write_token(stmt->keyword);
+        write(stmt->value);
+
+        return nullptr;
+    }
+
+    std::shared_ptr<ast::expr::Expr<std::shared_ptr<object::Object>>> AstReader::read_expr() {
+        using R = std::shared_ptr<object::Object>;
+
+        switch (static_cast<Node>(reader->read_u8())) {
+            case Node::Null:
+                return nullptr;
+            case Node::Literal:
+                return std::make_shared<ast::expr::Literal<R>>(reader->read_literal());
+            case Node::Grouping:
+                return std::make_shared<ast::expr::Grouping<R>>(read_expr());
+            case Node::Unary: {
+                const token::Token operator_ {reader->read_token()};
+                auto right {read_expr()};
+
+                return std::make_shared<ast::expr::Unary<R>>(operator_, right);
+            }
+            case Node::Binary: {
+                auto left {read_expr()};
+                const token::Token operator_ {reader->read_token()};
+                auto right {read_expr()};
+
+                return std::make_shared<ast::expr::Binary<R>>(left, operator_, right);
+            }
+            case Node::Variable:
+                return std::make_shared<ast::expr::Variable<R>>(reader->read_token());
+            case Node::Assignment: {
+                const token::Token name {reader->read_token()};
+                auto value {read_expr()};
+
+                return std::make_shared<ast::expr::Assignment<R>>(name, value);
+            }
+            case Node::Logical: {
+                auto left {read_expr()};
+                const token::Token operator_ {reader->read_token()};
+                auto right {read_expr()};
+
+                return std::make_shared<ast::expr::Logical<R>>(left, operator_, right);
+            }
+            case Node::Call: {
+                auto callee {read_expr()};
+                const token::Token paren {reader->read_token()};
+                auto arguments {read_exprs()};
+
+                return std::make_shared<ast::expr::Call<R>>(callee, paren, arguments);
+            }
+            case Node::Get: {
+                auto object {read_expr()};
+                const token::Token name {reader->read_token()};
+
+                return std::make_shared<ast::expr::Get<R>>(object, name);
+            }
+            case Node::Set: {
+                auto object {read_expr()};
+                const token::Token name {reader->read_token()};
+                auto value {read_expr()};
+
+                return std::make_shared<ast::expr::Set<R>>(object, name, value);
+            }
+            case Node::Array: {
+                const token::Token bracket {reader->read_token()};
+                auto elements {read_exprs()};
+
+                return std::make_shared<ast::expr::Array<R>>(bracket, elements);
+            }
+            case Node::Index: {
+                auto object {read_expr()};
+                const token::Token bracket {reader->read_token()};
+                auto index {read_expr()};
+
+                return std::make_shared<ast::expr::Index<R>>(object, bracket, index);
+            }
+            case Node::IndexSet: {
+                auto object {read_expr()};
+                const token::Token bracket {reader->read_token()};
+                auto index {read_expr()};
+                auto value {read_expr()};
+
+                return std::make_shared<ast::expr::IndexSet<R>>(object, bracket, index, value);
+            }
+            case Node::MapLiteral: {
+                const token::Token brace {reader->read_token()};
+                auto keys {read_exprs()};
+                auto values {read_exprs()};
+
+                if (keys.size() != values.size()) {
+                    throw Error();
+                }
+
+                return std::make_shared<ast::expr::MapLiteral<R>>(brace, keys, values);
+            }
+            case Node::SetLiteral: {
+                const token::Token brace {reader->read_token()};
+                auto elements {read_exprs()};
+
+                return std::make_shared<ast::expr::SetLiteral<R>>(brace, elements);
+            }
+            default:
+                throw Error();
+        }
+    }
+
+    std::shared_ptr<ast::stmt::Stmt<std::shared_ptr<object::Object>>> AstReader::read_stmt() {
+        auto stmt {read_stmt_node()};
+
+        if (stmt != nullptr) {
+            stmt->line = static_cast<std::size_t>(reader->read_u64());
+        }
+
+        return stmt;
+    }
+
+    std::shared_ptr<ast::stmt::Stmt<std::shared_ptr<object::Object>>> AstReader::read_stmt_node() {
+        using R = std::shared_ptr<object::Object>;
+
+        switch (static_cast<Node>(reader->read_u8())) {
+            case Node::Null:
+                return nullptr;
+            case Node::Expression:
+                return std::make_shared<ast::stmt::Expression<R>>(read_expr());
+            case Node::Let: {
+                const token::Token name {reader->read_token()};
+                auto initializer {read_expr()};
+
+                return std::make_shared<ast::stmt::Let<R>>(name, initializer);
+            }
+            case Node::Function:
+                return read_function();
+            case Node::Struct: {
+                const token::Token name {reader->read_token()};
+                const std::size_t size {read_size()};
+
+                std::vector<std::shared_ptr<ast::stmt::Function<R>>> methods;
+
+                for (std::size_t i {0u}; i < size; i++) {
+                    methods.push_back(read_function());
+                    methods.back()->line = static_cast<std::size_t>(reader->read_u64());
+                }
+
+                return std::make_shared<ast::stmt::Struct<R>>(name, methods);
+            }
+            case Node::If: {
+                auto condition {read_expr()};
+                auto then_branch {read_stmt()};
+                auto else_branch {read_stmt()};
+                const token::Token paren {reader->read_token()};
+
+                return std::make_shared<ast::stmt::If<R>>(condition, then_branch, else_branch, paren);
+            }
+            case Node::While: {
+                auto condition {read_expr()};
+                auto body {read_stmt()};
+                const token::Token paren {reader->read_token()};
+
+                return std::make_shared<ast::stmt::While<R>>(condition, body, paren);
+            }
+            case Node::ForRange: {
+                const token::Token name {reader->read_token()};
+                const token::Token range {reader->read_token()};
+                auto start {read_expr()};
+                auto stop {read_expr()};
+                auto step {read_expr()};
+                auto body {read_stmt()};
+
+                if (stop == nullptr || body == nullptr) {
+                    throw Error();
+                }
+
+                return std::make_shared<ast::stmt::ForRange<R>>(name, range, start, stop, step, body);
+            }
+            case Node::Block:
+                return std::make_shared<ast::stmt::Block<R>>(read_stmts());
+            case Node::Return: {
+                const token::Token keyword {reader->read_token()};
+                auto value {read_expr()};
+
+                return std::make_shared<ast::stmt::Return<R>>(keyword, value);
+            }
+            default:
+                throw Error();
+        }
+    }
+
+    std::vector<std::shared_ptr<ast::stmt::Stmt<std::shared_ptr<object::Object>>>> AstReader::read_stmts() {
+        const std::size_t size {read_size()};
+
+        std::vector<std::shared_ptr<ast::stmt::Stmt<std::shared_ptr<object::Object>>>> stmts;
+        stmts.reserve(size);
+
+        for (std::size_t i {0u}; i < size; i++) {
+            stmts.push_back(read_stmt());
+        }
+
+        return stmts;
+    }
+
+    std::vector<std::shared_ptr<ast::expr::Expr<std::shared_ptr<object::Object>>>> AstReader::read_exprs() {
+        const std::size_t size {read_size()};
+
+        std::vector<std::shared_ptr<ast::expr::Expr<std::shared_ptr<object::Object>>>> exprs;
+        exprs.reserve(size);
+
+        for (std::size_t i {0u}; i < size; i++) {
+            exprs.push_back(read_expr());
+        }
+
+        return exprs;
+    }
+
+    std::shared_ptr<ast::stmt::Function<std::shared_ptr<object::Object>>> AstReader::read_function() {
+        const token::Token name {reader->read_token()};
+        const std::vector<token::Token> parameters {read_tokens()};
+        auto body {read_stmts()};
+        const bool memoized {reader->read_u8() != 0u};
+
+        return std::make_shared<ast::stmt::Function<std::shared_ptr<object::Object>>>(name, parameters, body, memoized);
+    }
+
+    std::vector<token::Token> AstReader::read_tokens() {
+        const std::size_t size {read_size()};
+
+        std::vector<token::Token> tokens;
+        tokens.reserve(size);
+
+        for (std::size_t i {0u}; i < size; i++) {
+            tokens.push_back(reader->read_token());
+        }
+
+        return tokens;
+    }
+
+    std::size_t AstReader::read_size() {
+        const std::uint64_t size {reader->read_u64()};
+
+        // Every element takes at least one byte, which guards against absurd allocations
+        if (size > reader->remaining()) {
+            throw Error();
+        }
+
+        return static_cast<std::size_t>(size);
+    }
+
+    void write_statements(
+        Writer& writer,
+        const std::vector<std::shared_ptr<ast::stmt::Stmt<std::shared_ptr<object::Object>>>>& statements
+    ) {
+        AstWriter(&writer).write(statements);
+    }
+
+    std::vector<std::shared_ptr<ast::stmt::Stmt<std::shared_ptr<object::Object>>>> read_statements(Reader& reader) {
+        return AstReader(&reader).read_stmts();
+    }
+
+    std::uint64_t hash(std::string_view data) {
+        std::uint64_t result {0xCBF29CE484222325u};
+
+        for (const char character : data) {
+            result ^= static_cast<std::uint8_t>(character);
+            result *= 0x100000001B3u;
+        }
+
+        return result;
+    }
+}
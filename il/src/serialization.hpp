@@ -0,0 +1,64 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+
+#include "ast.hpp"
+#include "object.hpp"
+#include "token.hpp"
+
+// Compact binary encoding of tokens, literal objects and syntax trees
+// Integers are stored as LEB128 varints, so the format doesn't depend on the host's endianness
+namespace serialization {
+    // Thrown by the reader when the data is truncated or malformed
+    struct Error {};
+
+    class Writer {
+    public:
+        void write_u8(std::uint8_t value);
+        void write_u64(std::uint64_t value);
+        void write_i64(std::int64_t value);
+        void write_f64(double value);
+        void write_string(std::string_view value);
+        void write_token(const token::Token& token);
+        void write_literal(const std::shared_ptr<object::Object>& value);
+
+        const std::string& get_data() const { return data; }
+    private:
+        std::string data;
+    };
+
+    class Reader {
+    public:
+        explicit Reader(std::string_view data)
+            : data(data) {}
+
+        std::uint8_t read_u8();
+        std::uint64_t read_u64();
+        std::int64_t read_i64();
+        double read_f64();
+        std::string read_string();
+        token::Token read_token();
+        std::shared_ptr<object::Object> read_literal();
+
+        bool reached_end() const { return current == data.size(); }
+        std::size_t remaining() const { return data.size() - current; }
+    private:
+        std::string_view data;
+        std::size_t current {};
+    };
+
+    void write_statements(
+        Writer& writer,
+        const std::vector<std::shared_ptr<ast::stmt::Stmt<std::shared_ptr<object::Object>>>>& statements
+    );
+
+    std::vector<std::shared_ptr<ast::stmt::Stmt<std::shared_ptr<object::Object>>>> read_statements(Reader& reader);
+
+    // FNV-1a
+    std::uint64_t hash(std::string_view data);
+}
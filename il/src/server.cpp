@@ -0,0 +1,381 @@
+#include "server.hpp"
+
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <unordered_map>
+#include <unordered_set>
+#include <filesystem>
+#include <chrono>
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+#include <csignal>
+
+#if defined(__unix__) || defined(__APPLE__)
+    #include <sys/socket.h>
+    #include <sys/stat.h>
+    #include <sys/un.h>
+    #include <poll.h>
+    #include <signal.h>
+    #include <unistd.h>
+#endif
+
+#include "il.hpp"
+#include "program.hpp"
+#include "protocol.hpp"
+
+namespace server {
+#if defined(__unix__) || defined(__APPLE__)
+    // The listening thread looks up every so often whether it was interrupted
+    static constexpr std::chrono::milliseconds POLL_INTERVAL {100};
+
+    // Compiled programs are all dropped once there are this many
+    static constexpr std::size_t MAX_PROGRAMS {1024u};
+
+    static volatile std::sig_atomic_t g_interrupted {0};
+
+    static void handle_signal(int) {
+        g_interrupted = 1;
+    }
+
+    struct Request {
+        bool source {false};  // The script is source code, instead of a file path
+        std::string script;
+        std::vector<std::string> arguments;
+    };
+
+    // One interpreter per thread, kept for as long as the server runs
+    struct Worker {
+        Worker()
+            : output(&output_buffer), errors(&error_buffer), il(&output, &errors, &input) {}
+
+        protocol::FrameBuffer output_buffer {protocol::Frame::Output};
+        protocol::FrameBuffer error_buffer {protocol::Frame::Errors};
+        std::ostream output;
+        std::ostream errors;
+        std::istringstream input;  // Requests get no input
+        Il il;
+    };
+
+    struct Compiled {
+        std::shared_ptr<const Program> program;
+        std::filesystem::file_time_type time;  // Of the file, when it was compiled
+        std::uintmax_t size {};
+    };
+
+    // False once the client is gone or if it sent something malformed
+    static bool read_request(int descriptor, Request& request) {
+        request = Request();
+
+        protocol::Frame type {};
+        std::string payload;
+        bool has_script {false};
+
+        while (protocol::read_frame(descriptor, type, payload)) {
+            switch (type) {
+                case protocol::Frame::File:
+                case protocol::Frame::Source:
+                    if (has_script) {
+                        return false;
+                    }
+
+                    request.source = type == protocol::Frame::Source;
+                    request.script = std::move(payload);
+                    has_script = true;
+                    break;
+                case protocol::Frame::Argument:
+                    request.arguments.push_back(std::move(payload));
+                    break;
+                case protocol::Frame::Run:
+                    return has_script;
+                default:
+                    return false;
+            }
+        }
+
+        return false;
+    }
+
+    // Connections are served by one worker from start to end, so clients shouldn't hold on to idle connections
+    class Server {
+    public:
+        Server(unsigned int workers, const std::function<void(Il&)>& configure);
+        ~Server() noexcept;
+
+        Server(const Server&) = delete;
+        Server& operator=(const Server&) = delete;
+
+        void accept(int descriptor);
+    private:
+        void work();
+        void serve(Worker& worker, int descriptor);
+        int execute(Worker& worker, const Request& request);
+        std::shared_ptr<const Program> compile(Worker& worker, const Request& request);
+
+        std::function<void(Il&)> configure;
+        std::vector<std::thread> threads;
+
+        std::mutex mutex;
+        std::condition_variable connection_available;
+        std::deque<int> connections;  // Accepted, but not taken by any worker yet
+        std::unordered_set<int> active;  // Being served
+        bool stopping {false};
+
+        // Keyed by the file path or by the source code, after the type of the request
+        std::mutex programs_mutex;
+        std::unordered_map<std::string, Compiled> programs;
+    };
+
+    Server::Server(unsigned int workers, const std::function<void(Il&)>& configure)
+        : configure(configure) {
+        for (unsigned int i {0u}; i < workers; i++) {
+            threads.emplace_back(&Server::work, this);
+        }
+    }
+
+    // Requests being run are finished first, then their connections are shut down
+    Server::~Server() noexcept {
+        {
+            std::lock_guard<std::mutex> lock {mutex};
+            stopping = true;
+
+            for (const int descriptor : active) {
+                ::shutdown(descriptor, SHUT_RDWR);
+            }
+
+            for (const int descriptor : connections) {
+                ::close(descriptor);
+            }
+
+            connections.clear();
+        }
+
+        connection_available.notify_all();
+
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+    }
+
+    void Server::accept(int descriptor) {
+        {
+            std::lock_guard<std::mutex> lock {mutex};
+            connections.push_back(descriptor);
+        }
+
+        connection_available.notify_one();
+    }
+
+    void Server::work() {
+        // Created on its own thread, as interpreters keep some of their state per thread
+        Worker worker;
+        configure(worker.il);
+
+        while (true) {
+            int descriptor {-1};
+
+            {
+                std::unique_lock<std::mutex> lock {mutex};
+                connection_available.wait(lock, [this]() { return stopping || !connections.empty(); });
+
+                if (stopping) {
+                    return;
+                }
+
+                descriptor = connections.front();
+                connections.pop_front();
+                active.insert(descriptor);
+            }
+
+            serve(worker, descriptor);
+
+            {
+                std::lock_guard<std::mutex> lock {mutex};
+                active.erase(descriptor);
+            }
+
+            ::close(descriptor);
+        }
+    }
+
+    void Server::serve(Worker& worker, int descriptor) {
+        Request request;
+
+        while (read_request(descriptor, request)) {
+            worker.output_buffer.set_descriptor(descriptor);
+            worker.error_buffer.set_descriptor(descriptor);
+
+            const int status {execute(worker, request)};
+
+            worker.output.flush();
+            worker.errors.flush();
+
+            worker.output_buffer.set_descriptor(-1);
+            worker.error_buffer.set_descriptor(-1);
+
+            if (!protocol::write_frame(descriptor, protocol::Frame::Exit, std::to_string(status))) {
+                return;
+            }
+        }
+    }
+
+    int Server::execute(Worker& worker, const Request& request) {
+        const std::shared_ptr<const Program> program {compile(worker, request)};
+
+        if (program == nullptr) {
+            return 1;
+        }
+
+        worker.il.set_arguments(request.arguments);
+
+        return worker.il.run_program(*program);
+    }
+
+    // Compiling errors are reported to the client every time, as failed programs are not kept
+    std::shared_ptr<const Program> Server::compile(Worker& worker, const Request& request) {
+        Compiled compiled;
+        const std::string key {(request.source ? 'S' : 'F') + request.script};
+
+        if (!request.source) {
+            std::error_code code;
+            compiled.time = std::filesystem::last_write_time(request.script, code);
+            compiled.size = std::filesystem::file_size(request.script, code);
+
+            if (code) {
+                return worker.il.compile_file(request.script);  // Let it report the error
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock {programs_mutex};
+
+            const auto iter {programs.find(key)};
+
+            if (iter != programs.cend() && iter->second.time == compiled.time && iter->second.size == compiled.size) {
+                return iter->second.program;
+            }
+        }
+
+        // Workers may compile the same program at the same time; one of them wins
+        if (request.source) {
+            compiled.program = worker.il.compile_source(request.script, "<source>");
+        } else {
+            compiled.program = worker.il.compile_file(request.script);
+        }
+
+        if (compiled.program == nullptr) {
+            return nullptr;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock {programs_mutex};
+
+            if (programs.size() >= MAX_PROGRAMS) {
+                programs.clear();
+            }
+
+            programs[key] = compiled;
+        }
+
+        return compiled.program;
+    }
+
+    static int listen_on(const std::string& socket_path) {
+        sockaddr_un address {};
+        address.sun_family = AF_UNIX;
+
+        if (socket_path.size() >= sizeof(address.sun_path)) {
+            std::cerr << "il: socket path `" << socket_path << "` is too long\n";
+            return -1;
+        }
+
+        std::memcpy(address.sun_path, socket_path.c_str(), socket_path.size() + 1u);
+
+        // A socket left behind by a previous server is replaced, but nothing else is
+        struct stat status {};
+
+        if (::lstat(socket_path.c_str(), &status) == 0) {
+            if (!S_ISSOCK(status.st_mode)) {
+                std::cerr << "il: `" << socket_path << "` exists and it's not a socket\n";
+                return -1;
+            }
+
+            ::unlink(socket_path.c_str());
+        }
+
+        const int descriptor {::socket(AF_UNIX, SOCK_STREAM, 0)};
+
+        if (descriptor < 0) {
+            std::cerr << "il: could not create a socket\n";
+            return -1;
+        }
+
+        if (::bind(descriptor, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 || ::listen(descriptor, SOMAXCONN) != 0) {
+            std::cerr << "il: could not listen on `" << socket_path << "`\n";
+            ::close(descriptor);
+            return -1;
+        }
+
+        return descriptor;
+    }
+
+    int run(const Options& options, const std::function<void(Il&)>& configure) {
+        const int listener {listen_on(options.socket_path)};
+
+        if (listener < 0) {
+            return 1;
+        }
+
+        // Clients going away must not take the server with them
+        std::signal(SIGPIPE, SIG_IGN);
+
+        struct sigaction action {};
+        action.sa_handler = handle_signal;
+        sigemptyset(&action.sa_mask);
+
+        sigaction(SIGINT, &action, nullptr);
+        sigaction(SIGTERM, &action, nullptr);
+
+        const unsigned int workers {options.workers > 0u ? options.workers : std::max(std::thread::hardware_concurrency(), 1u)};
+
+        {
+            Server server {workers, configure};
+
+            std::cerr << "il: serving on `" << options.socket_path << "` with " << workers << " workers\n";
+
+            while (!g_interrupted) {
+                pollfd poll_descriptor {listener, POLLIN, 0};
+
+                if (::poll(&poll_descriptor, 1u, static_cast<int>(POLL_INTERVAL.count())) <= 0) {
+                    continue;
+                }
+
+                const int connection {::accept(listener, nullptr, nullptr)};
+
+                if (connection >= 0) {
+                    server.accept(connection);
+                }
+            }
+
+            ::close(listener);
+            ::unlink(options.socket_path.c_str());
+        }
+
+        return 0;
+    }
+#else
+    int run(const Options&, const std::function<void(Il&)>&) {
+        std::cerr << "il: --serve is only available on POSIX systems\n";
+
+        return 1;
+    }
+#endif
+}
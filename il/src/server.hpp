@@ -0,0 +1,18 @@
+#pragma once
+
+#include <string>
+#include <functional>
+
+class Il;
+
+// Keeps interpreters warm on a pool of threads and runs scripts for clients connecting over a Unix domain socket;
+// every request starts with fresh globals, and compiled programs are shared by the workers until their files change
+namespace server {
+    struct Options {
+        std::string socket_path;
+        unsigned int workers {0u};  // Zero means one per hardware thread
+    };
+
+    // Serves until interrupted by SIGINT or SIGTERM; POSIX only
+    int run(const Options& options, const std::function<void(Il&)>& configure);
+}
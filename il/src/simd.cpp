@@ -0,0 +1,729 @@
+#include "simd.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #define IL_SIMD_X86
+    #include <immintrin.h>
+
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+    #endif
+#endif
+
+// Compile single functions for AVX2, while the rest of the program stays compatible with any x86-64 processor
+#if defined(__GNUC__)
+    #define IL_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+    #define IL_TARGET_AVX2
+#endif
+
+namespace simd {
+    // Float sums and dot products accumulate in eight lanes, that are reduced in this order by every kernel
+    static constexpr std::size_t LANES {8u};
+
+    static double reduce(const double* lanes) {
+        return ((lanes[0u] + lanes[4u]) + (lanes[2u] + lanes[6u])) + ((lanes[1u] + lanes[5u]) + (lanes[3u] + lanes[7u]));
+    }
+
+    // Float min and max return NaN if any element is NaN, whatever the instruction set; the vector instructions
+    // would otherwise return one or the other operand depending on their order
+    static constexpr double NOT_A_NUMBER {std::numeric_limits<double>::quiet_NaN()};
+
+    // Signed overflow is undefined, so integer arithmetic is done in unsigned and converted back
+    static long long wrap_add(long long left, long long right) {
+        return static_cast<long long>(static_cast<unsigned long long>(left) + static_cast<unsigned long long>(right));
+    }
+
+    static long long wrap_mul(long long left, long long right) {
+        return static_cast<long long>(static_cast<unsigned long long>(left) * static_cast<unsigned long long>(right));
+    }
+
+    namespace scalar {
+        static long long sum(const long long* data, std::size_t size) {
+            long long result {0ll};
+
+            for (std::size_t i {0u}; i < size; i++) {
+                result = wrap_add(result, data[i]);
+            }
+
+            return result;
+        }
+
+        static double sum(const double* data, std::size_t size) {
+            double lanes[LANES] {};
+            std::size_t i {0u};
+
+            for (; i + LANES <= size; i += LANES) {
+                for (std::size_t j {0u}; j < LANES; j++) {
+                    lanes[j] += data[i + j];
+                }
+            }
+
+            double result {reduce(lanes)};
+
+            for (; i < size; i++) {
+                result += data[i];
+            }
+
+            return result;
+        }
+
+        template<typename T>
+        static T min(const T* data, std::size_t size) {
+            return *std::min_element(data, data + size);
+        }
+
+        template<typename T>
+        static T max(const T* data, std::size_t size) {
+            return *std::max_element(data, data + size);
+        }
+
+        static double min(const double* data, std::size_t size) {
+            double result {data[0u]};
+
+            for (std::size_t i {0u}; i < size; i++) {
+                if (std::isnan(data[i])) {
+                    return NOT_A_NUMBER;
+                }
+
+                result = std::min(result, data[i]);
+            }
+
+            return result;
+        }
+
+        static double max(const double* data, std::size_t size) {
+            double result {data[0u]};
+
+            for (std::size_t i {0u}; i < size; i++) {
+                if (std::isnan(data[i])) {
+                    return NOT_A_NUMBER;
+                }
+
+                result = std::max(result, data[i]);
+            }
+
+            return result;
+        }
+
+        static long long dot(const long long* left, const long long* right, std::size_t size) {
+            long long result {0ll};
+
+            for (std::size_t i {0u}; i < size; i++) {
+                result = wrap_add(result, wrap_mul(left[i], right[i]));
+            }
+
+            return result;
+        }
+
+        static double dot(const double* left, const double* right, std::size_t size) {
+            double lanes[LANES] {};
+            std::size_t i {0u};
+
+            for (; i + LANES <= size; i += LANES) {
+                for (std::size_t j {0u}; j < LANES; j++) {
+                    lanes[j] += left[i + j] * right[i + j];
+                }
+            }
+
+            double result {reduce(lanes)};
+
+            for (; i < size; i++) {
+                result += left[i] * right[i];
+            }
+
+            return result;
+        }
+
+        static void add(const long long* left, const long long* right, long long* result, std::size_t size) {
+            for (std::size_t i {0u}; i < size; i++) {
+                result[i] = wrap_add(left[i], right[i]);
+            }
+        }
+
+        static void add(const double* left, const double* right, double* result, std::size_t size) {
+            for (std::size_t i {0u}; i < size; i++) {
+                result[i] = left[i] + right[i];
+            }
+        }
+
+        static void mul(const double* left, const double* right, double* result, std::size_t size) {
+            for (std::size_t i {0u}; i < size; i++) {
+                result[i] = left[i] * right[i];
+            }
+        }
+
+        static void scale(const double* data, double factor, double* result, std::size_t size) {
+            for (std::size_t i {0u}; i < size; i++) {
+                result[i] = data[i] * factor;
+            }
+        }
+    }
+
+#ifdef IL_SIMD_X86
+    // SSE2 is part of x86-64, so it is always available
+    namespace sse2 {
+        static long long sum(const long long* data, std::size_t size) {
+            __m128i accumulator {_mm_setzero_si128()};
+            std::size_t i {0u};
+
+            for (; i + 2u <= size; i += 2u) {
+                accumulator = _mm_add_epi64(accumulator, _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)));
+            }
+
+            long long lanes[2u] {};
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), accumulator);
+
+            long long result {wrap_add(lanes[0u], lanes[1u])};
+
+            for (; i < size; i++) {
+                result = wrap_add(result, data[i]);
+            }
+
+            return result;
+        }
+
+        static double sum(const double* data, std::size_t size) {
+            __m128d accumulators[4u] {_mm_setzero_pd(), _mm_setzero_pd(), _mm_setzero_pd(), _mm_setzero_pd()};
+            std::size_t i {0u};
+
+            for (; i + LANES <= size; i += LANES) {
+                for (std::size_t j {0u}; j < 4u; j++) {
+                    accumulators[j] = _mm_add_pd(accumulators[j], _mm_loadu_pd(data + i + j * 2u));
+                }
+            }
+
+            double lanes[LANES] {};
+
+            for (std::size_t j {0u}; j < 4u; j++) {
+                _mm_storeu_pd(lanes + j * 2u, accumulators[j]);
+            }
+
+            double result {reduce(lanes)};
+
+            for (; i < size; i++) {
+                result += data[i];
+            }
+
+            return result;
+        }
+
+        static double min(const double* data, std::size_t size) {
+            __m128d best {_mm_set1_pd(data[0u])};
+            __m128d unordered {_mm_setzero_pd()};
+            std::size_t i {0u};
+
+            for (; i + 2u <= size; i += 2u) {
+                const __m128d values {_mm_loadu_pd(data + i)};
+                best = _mm_min_pd(best, values);
+                unordered = _mm_or_pd(unordered, _mm_cmpunord_pd(values, values));
+            }
+
+            if (_mm_movemask_pd(unordered) != 0) {
+                return NOT_A_NUMBER;
+            }
+
+            double lanes[2u] {};
+            _mm_storeu_pd(lanes, best);
+
+            const double rest {i < size ? scalar::min(data + i, size - i) : lanes[0u]};
+
+            return std::isnan(rest) ? NOT_A_NUMBER : std::min(std::min(lanes[0u], lanes[1u]), rest);
+        }
+
+        static double max(const double* data, std::size_t size) {
+            __m128d best {_mm_set1_pd(data[0u])};
+            __m128d unordered {_mm_setzero_pd()};
+            std::size_t i {0u};
+
+            for (; i + 2u <= size; i += 2u) {
+                const __m128d values {_mm_loadu_pd(data + i)};
+                best = _mm_max_pd(best, values);
+                unordered = _mm_or_pd(unordered, _mm_cmpunord_pd(values, values));
+            }
+
+            if (_mm_movemask_pd(unordered) != 0) {
+                return NOT_A_NUMBER;
+            }
+
+            double lanes[2u] {};
+            _mm_storeu_pd(lanes, best);
+
+            const double rest {i < size ? scalar::max(data + i, size - i) : lanes[0u]};
+
+            return std::isnan(rest) ? NOT_A_NUMBER : std::max(std::max(lanes[0u], lanes[1u]), rest);
+        }
+
+        static double dot(const double* left, const double* right, std::size_t size) {
+            __m128d accumulators[4u] {_mm_setzero_pd(), _mm_setzero_pd(), _mm_setzero_pd(), _mm_setzero_pd()};
+            std::size_t i {0u};
+
+            for (; i + LANES <= size; i += LANES) {
+                for (std::size_t j {0u}; j < 4u; j++) {
+                    const __m128d product {_mm_mul_pd(_mm_loadu_pd(left + i + j * 2u), _mm_loadu_pd(right + i + j * 2u))};
+                    accumulators[j] = _mm_add_pd(accumulators[j], product);
+                }
+            }
+
+            double lanes[LANES] {};
+
+            for (std::size_t j {0u}; j < 4u; j++) {
+                _mm_storeu_pd(lanes + j * 2u, accumulators[j]);
+            }
+
+            double result {reduce(lanes)};
+
+            for (; i < size; i++) {
+                result += left[i] * right[i];
+            }
+
+            return result;
+        }
+
+        static void add(const long long* left, const long long* right, long long* result, std::size_t size) {
+            std::size_t i {0u};
+
+            for (; i + 2u <= size; i += 2u) {
+                const __m128i sum {_mm_add_epi64(
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(left + i)),
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(right + i))
+                )};
+
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(result + i), sum);
+            }
+
+            scalar::add(left + i, right + i, result + i, size - i);
+        }
+
+        static void add(const double* left, const double* right, double* result, std::size_t size) {
+            std::size_t i {0u};
+
+            for (; i + 2u <= size; i += 2u) {
+                _mm_storeu_pd(result + i, _mm_add_pd(_mm_loadu_pd(left + i), _mm_loadu_pd(right + i)));
+            }
+
+            scalar::add(left + i, right + i, result + i, size - i);
+        }
+
+        static void mul(const double* left, const double* right, double* result, std::size_t size) {
+            std::size_t i {0u};
+
+            for (; i + 2u <= size; i += 2u) {
+                _mm_storeu_pd(result + i, _mm_mul_pd(_mm_loadu_pd(left + i), _mm_loadu_pd(right + i)));
+            }
+
+            scalar::mul(left + i, right + i, result + i, size - i);
+        }
+
+        static void scale(const double* data, double factor, double* result, std::size_t size) {
+            const __m128d factors {_mm_set1_pd(factor)};
+            std::size_t i {0u};
+
+            for (; i + 2u <= size; i += 2u) {
+                _mm_storeu_pd(result + i, _mm_mul_pd(_mm_loadu_pd(data + i), factors));
+            }
+
+            scalar::scale(data + i, factor, result + i, size - i);
+        }
+    }
+
+    namespace avx2 {
+        IL_TARGET_AVX2
+        static long long sum(const long long* data, std::size_t size) {
+            __m256i accumulator {_mm256_setzero_si256()};
+            std::size_t i {0u};
+
+            for (; i + 4u <= size; i += 4u) {
+                accumulator = _mm256_add_epi64(accumulator, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)));
+            }
+
+            long long lanes[4u] {};
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), accumulator);
+
+            long long result {wrap_add(wrap_add(lanes[0u], lanes[1u]), wrap_add(lanes[2u], lanes[3u]))};
+
+            for (; i < size; i++) {
+                result = wrap_add(result, data[i]);
+            }
+
+            return result;
+        }
+
+        IL_TARGET_AVX2
+        static double sum(const double* data, std::size_t size) {
+            __m256d low {_mm256_setzero_pd()};
+            __m256d high {_mm256_setzero_pd()};
+            std::size_t i {0u};
+
+            for (; i + LANES <= size; i += LANES) {
+                low = _mm256_add_pd(low, _mm256_loadu_pd(data + i));
+                high = _mm256_add_pd(high, _mm256_loadu_pd(data + i + 4u));
+            }
+
+            double lanes[LANES] {};
+            _mm256_storeu_pd(lanes, low);
+            _mm256_storeu_pd(lanes + 4u, high);
+
+            double result {reduce(lanes)};
+
+            for (; i < size; i++) {
+                result += data[i];
+            }
+
+            return result;
+        }
+
+        IL_TARGET_AVX2
+        static long long min(const long long* data, std::size_t size) {
+            __m256i best {_mm256_set1_epi64x(data[0u])};
+            std::size_t i {0u};
+
+            for (; i + 4u <= size; i += 4u) {
+                const __m256i values {_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i))};
+                best = _mm256_blendv_epi8(best, values, _mm256_cmpgt_epi64(best, values));
+            }
+
+            long long lanes[4u] {};
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), best);
+
+            long long result {scalar::min(lanes, 4u)};
+
+            for (; i < size; i++) {
+                result = std::min(result, data[i]);
+            }
+
+            return result;
+        }
+
+        IL_TARGET_AVX2
+        static long long max(const long long* data, std::size_t size) {
+            __m256i best {_mm256_set1_epi64x(data[0u])};
+            std::size_t i {0u};
+
+            for (; i + 4u <= size; i += 4u) {
+                const __m256i values {_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i))};
+                best = _mm256_blendv_epi8(best, values, _mm256_cmpgt_epi64(values, best));
+            }
+
+            long long lanes[4u] {};
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), best);
+
+            long long result {scalar::max(lanes, 4u)};
+
+            for (; i < size; i++) {
+                result = std::max(result, data[i]);
+            }
+
+            return result;
+        }
+
+        IL_TARGET_AVX2
+        static double min(const double* data, std::size_t size) {
+            __m256d best {_mm256_set1_pd(data[0u])};
+            __m256d unordered {_mm256_setzero_pd()};
+            std::size_t i {0u};
+
+            for (; i + 4u <= size; i += 4u) {
+                const __m256d values {_mm256_loadu_pd(data + i)};
+                best = _mm256_min_pd(best, values);
+                unordered = _mm256_or_pd(unordered, _mm256_cmp_pd(values, values, _CMP_UNORD_Q));
+            }
+
+            if (_mm256_movemask_pd(unordered) != 0) {
+                return NOT_A_NUMBER;
+            }
+
+            double lanes[4u] {};
+            _mm256_storeu_pd(lanes, best);
+
+            const double rest {i < size ? scalar::min(data + i, size - i) : lanes[0u]};
+
+            return std::isnan(rest) ? NOT_A_NUMBER : std::min(scalar::min(lanes, 4u), rest);
+        }
+
+        IL_TARGET_AVX2
+        static double max(const double* data, std::size_t size) {
+            __m256d best {_mm256_set1_pd(data[0u])};
+            __m256d unordered {_mm256_setzero_pd()};
+            std::size_t i {0u};
+
+            for (; i + 4u <= size; i += 4u) {
+                const __m256d values {_mm256_loadu_pd(data + i)};
+                best = _mm256_max_pd(best, values);
+                unordered = _mm256_or_pd(unordered, _mm256_cmp_pd(values, values, _CMP_UNORD_Q));
+            }
+
+            if (_mm256_movemask_pd(unordered) != 0) {
+                return NOT_A_NUMBER;
+            }
+
+            double lanes[4u] {};
+            _mm256_storeu_pd(lanes, best);
+
+            const double rest {i < size ? scalar::max(data + i, size - i) : lanes[0u]};
+
+            return std::isnan(rest) ? NOT_A_NUMBER : std::max(scalar::max(lanes, 4u), rest);
+        }
+
+        IL_TARGET_AVX2
+        static double dot(const double* left, const double* right, std::size_t size) {
+            __m256d low {_mm256_setzero_pd()};
+            __m256d high {_mm256_setzero_pd()};
+            std::size_t i {0u};
+
+            // No fused multiply-add, as it would round differently than the other kernels
+            for (; i + LANES <= size; i += LANES) {
+                low = _mm256_add_pd(low, _mm256_mul_pd(_mm256_loadu_pd(left + i), _mm256_loadu_pd(right + i)));
+                high = _mm256_add_pd(high, _mm256_mul_pd(_mm256_loadu_pd(left + i + 4u), _mm256_loadu_pd(right + i + 4u)));
+            }
+
+            double lanes[LANES] {};
+            _mm256_storeu_pd(lanes, low);
+            _mm256_storeu_pd(lanes + 4u, high);
+
+            double result {reduce(lanes)};
+
+            for (; i < size; i++) {
+                result += left[i] * right[i];
+            }
+
+            return result;
+        }
+
+        IL_TARGET_AVX2
+        static void add(const long long* left, const long long* right, long long* result, std::size_t size) {
+            std::size_t i {0u};
+
+            for (; i + 4u <= size; i += 4u) {
+                const __m256i sum {_mm256_add_epi64(
+                    _mm256_loadu_si256(reinterpret_cast<const __m256i*>(left + i)),
+                    _mm256_loadu_si256(reinterpret_cast<const __m256i*>(right + i))
+                )};
+
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(result + i), sum);
+            }
+
+            scalar::add(left + i, right + i, result + i, size - i);
+        }
+
+        IL_TARGET_AVX2
+        static void add(const double* left, const double* right, double* result, std::size_t size) {
+            std::size_t i {0u};
+
+            for (; i + 4u <= size; i += 4u) {
+                _mm256_storeu_pd(result + i, _mm256_add_pd(_mm256_loadu_pd(left + i), _mm256_loadu_pd(right + i)));
+            }
+
+            scalar::add(left + i, right + i, result + i, size - i);
+        }
+
+        IL_TARGET_AVX2
+        static void mul(const double* left, const double* right, double* result, std::size_t size) {
+            std::size_t i {0u};
+
+            for (; i + 4u <= size; i += 4u) {
+                _mm256_storeu_pd(result + i, _mm256_mul_pd(_mm256_loadu_pd(left + i), _mm256_loadu_pd(right + i)));
+            }
+
+            scalar::mul(left + i, right + i, result + i, size - i);
+        }
+
+        IL_TARGET_AVX2
+        static void scale(const double* data, double factor, double* result, std::size_t size) {
+            const __m256d factors {_mm256_set1_pd(factor)};
+            std::size_t i {0u};
+
+            for (; i + 4u <= size; i += 4u) {
+                _mm256_storeu_pd(result + i, _mm256_mul_pd(_mm256_loadu_pd(data + i), factors));
+            }
+
+            scalar::scale(data + i, factor, result + i, size - i);
+        }
+    }
+
+    static Level detect() {
+#if defined(__GNUC__)
+        __builtin_cpu_init();
+
+        return __builtin_cpu_supports("avx2") ? Level::Avx2 : Level::Sse2;
+#elif defined(_MSC_VER)
+        int info[4u] {};
+
+        __cpuid(info, 0);
+        const int leaves {info[0u]};
+
+        // The operating system must also save the AVX registers on context switches
+        __cpuid(info, 1);
+        const bool avx {(info[2u] & (1 << 27)) != 0 && (info[2u] & (1 << 28)) != 0 && (_xgetbv(0u) & 6u) == 6u};
+
+        if (avx && leaves >= 7) {
+            __cpuidex(info, 7, 0);
+
+            if ((info[1u] & (1 << 5)) != 0) {
+                return Level::Avx2;
+            }
+        }
+
+        return Level::Sse2;
+#else
+        return Level::Sse2;
+#endif
+    }
+#else
+    static Level detect() {
+        return Level::Scalar;
+    }
+#endif
+
+    Level level() {
+        static const Level result {detect()};
+
+        return result;
+    }
+
+    const char* level_name(Level level) {
+        switch (level) {
+            case Level::Scalar:
+                return "scalar";
+            case Level::Sse2:
+                return "sse2";
+            case Level::Avx2:
+                return "avx2";
+        }
+
+        return "";
+    }
+
+// Call the kernel of the detected instruction set, falling back to the next best one
+#ifdef IL_SIMD_X86
+    #define IL_DISPATCH_AVX2(call) if (level() == Level::Avx2) { return avx2::call; }
+    #define IL_DISPATCH_SSE2(call) if (level() != Level::Scalar) { return sse2::call; }
+#else
+    #define IL_DISPATCH_AVX2(call)
+    #define IL_DISPATCH_SSE2(call)
+#endif
+
+    long long sum(const long long* data, std::size_t size) {
+        IL_DISPATCH_AVX2(sum(data, size))
+        IL_DISPATCH_SSE2(sum(data, size))
+
+        return scalar::sum(data, size);
+    }
+
+    double sum(const double* data, std::size_t size) {
+        IL_DISPATCH_AVX2(sum(data, size))
+        IL_DISPATCH_SSE2(sum(data, size))
+
+        return scalar::sum(data, size);
+    }
+
+    // SSE2 has no 64-bit integer comparisons
+    long long min(const long long* data, std::size_t size) {
+        IL_DISPATCH_AVX2(min(data, size))
+
+        return scalar::min(data, size);
+    }
+
+    double min(const double* data, std::size_t size) {
+        IL_DISPATCH_AVX2(min(data, size))
+        IL_DISPATCH_SSE2(min(data, size))
+
+        return scalar::min(data, size);
+    }
+
+    long long max(const long long* data, std::size_t size) {
+        IL_DISPATCH_AVX2(max(data, size))
+
+        return scalar::max(data, size);
+    }
+
+    double max(const double* data, std::size_t size) {
+        IL_DISPATCH_AVX2(max(data, size))
+        IL_DISPATCH_SSE2(max(data, size))
+
+        return scalar::max(data, size);
+    }
+
+    // There is no 64-bit integer multiplication before AVX-512, so integer products are always scalar
+    long long dot(const long long* left, const long long* right, std::size_t size) {
+        return scalar::dot(left, right, size);
+    }
+
+    double dot(const double* left, const double* right, std::size_t size) {
+        IL_DISPATCH_AVX2(dot(left, right, size))
+        IL_DISPATCH_SSE2(dot(left, right, size))
+
+        return scalar::dot(left, right, size);
+    }
+
+    void add(const long long* left, const long long* right, long long* result, std::size_t size) {
+        IL_DISPATCH_AVX2(add(left, right, result, size))
+        IL_DISPATCH_SSE2(add(left, right, result, size))
+
+        scalar::add(left, right, result, size);
+    }
+
+    void add(const double* left, const double* right, double* result, std::size_t size) {
+        IL_DISPATCH_AVX2(add(left, right, result, size))
+        IL_DISPATCH_SSE2(add(left, right, result, size))
+
+        scalar::add(left, right, result, size);
+    }
+
+    void mul(const long long* left, const long long* right, long long* result, std::size_t size) {
+        for (std::size_t i {0u}; i < size; i++) {
+            result[i] = wrap_mul(left[i], right[i]);
+        }
+    }
+
+    void mul(const double* left, const double* right, double* result, std::size_t size) {
+        IL_DISPATCH_AVX2(mul(left, right, result, size))
+        IL_DISPATCH_SSE2(mul(left, right, result, size))
+
+        scalar::mul(left, right, result, size);
+    }
+
+    void scale(const long long* data, long long factor, long long* result, std::size_t size) {
+        for (std::size_t i {0u}; i < size; i++) {
+            result[i] = wrap_mul(data[i], factor);
+        }
+    }
+
+    void scale(const double* data, double factor, double* result, std::size_t size) {
+        IL_DISPATCH_AVX2(scale(data, factor, result, size))
+        IL_DISPATCH_SSE2(scale(data, factor, result, size))
+
+        scalar::scale(data, factor, result, size);
+    }
+
+    // Every element depends on the previous one, so prefix sums are sequential at any instruction set
+    void prefix_sum(const long long* data, long long* result, std::size_t size) {
+        long long sum {0ll};
+
+        for (std::size_t i {0u}; i < size; i++) {
+            sum = wrap_add(sum, data[i]);
+            result[i] = sum;
+        }
+    }
+
+    void prefix_sum(const double* data, double* result, std::size_t size) {
+        double sum {0.0};
+
+        for (std::size_t i {0u}; i < size; i++) {
+            sum += data[i];
+            result[i] = sum;
+        }
+    }
+
+    // Plain stores, which the compiler vectorizes on its own
+    void fill(long long* data, long long value, std::size_t size) {
+        std::fill(data, data + size, value);
+    }
+
+    void fill(double* data, double value, std::size_t size) {
+        std::fill(data, data + size, value);
+    }
+}
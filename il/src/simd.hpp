@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+
+namespace simd {
+    enum class Level {
+        Scalar,
+        Sse2,
+        Avx2
+    };
+
+    // The best instruction set supported by the processor, detected on the first call
+    Level level();
+    const char* level_name(Level level);
+
+    // Kernels over raw arrays, dispatched to the detected instruction set
+    // Integer arithmetic wraps around; float sums and dot products always add in the same order, so that the
+    // results are the same on every processor
+    long long sum(const long long* data, std::size_t size);
+    double sum(const double* data, std::size_t size);
+
+    // The size must be greater than zero; float min and max return NaN if any element is NaN
+    long long min(const long long* data, std::size_t size);
+    double min(const double* data, std::size_t size);
+    long long max(const long long* data, std::size_t size);
+    double max(const double* data, std::size_t size);
+
+    long long dot(const long long* left, const long long* right, std::size_t size);
+    double dot(const double* left, const double* right, std::size_t size);
+
+    // The result may be the same array as one of the operands
+    void add(const long long* left, const long long* right, long long* result, std::size_t size);
+    void add(const double* left, const double* right, double* result, std::size_t size);
+    void mul(const long long* left, const long long* right, long long* result, std::size_t size);
+    void mul(const double* left, const double* right, double* result, std::size_t size);
+    void scale(const long long* data, long long factor, long long* result, std::size_t size);
+    void scale(const double* data, double factor, double* result, std::size_t size);
+
+    void prefix_sum(const long long* data, long long* result, std::size_t size);
+    void prefix_sum(const double* data, double* result, std::size_t size);
+
+    void fill(long long* data, long long value, std::size_t size);
+    void fill(double* data, double value, std::size_t size);
+}
@@ -0,0 +1,95 @@
+#include "stats.hpp"
+
+#include <iomanip>
+
+#include "object.hpp"
+
+namespace stats {
+    static_assert(static_cast<std::size_t>(object::Type::Channel) + 1u == TYPES);
+
+    static const char* type_name(std::size_t type) {
+        switch (static_cast<object::Type>(type)) {
+            case object::Type::None:
+                return "none";
+            case object::Type::String:
+                return "string";
+            case object::Type::Integer:
+                return "integer";
+            case object::Type::Float:
+                return "float";
+            case object::Type::Boolean:
+                return "boolean";
+            case object::Type::BuiltinFunction:
+                return "builtin function";
+            case object::Type::Function:
+                return "function";
+            case object::Type::Method:
+                return "method";
+            case object::Type::Struct:
+                return "struct";
+            case object::Type::StructInstance:
+                return "struct instance";
+            case object::Type::Array:
+                return "array";
+            case object::Type::Map:
+                return "map";
+            case object::Type::Set:
+                return "set";
+            case object::Type::IntArray:
+                return "int array";
+            case object::Type::FloatArray:
+                return "float array";
+            case object::Type::Task:
+                return "task";
+            case object::Type::Channel:
+                return "channel";
+        }
+
+        return "";
+    }
+
+    static double ratio(std::size_t numerator, std::size_t denominator) {
+        return denominator == 0u ? 0.0 : static_cast<double>(numerator) / static_cast<double>(denominator);
+    }
+
+    void report(std::ostream& stream) {
+        const auto flags {stream.flags()};
+        const auto precision {stream.precision()};
+
+        stream << "il: runtime statistics\n\n  objects allocated\n";
+
+        std::size_t total {0u};
+
+        for (std::size_t i {0u}; i < TYPES; i++) {
+            if (counters.allocations[i] == 0u) {
+                continue;
+            }
+
+            stream << "    " << std::left << std::setw(20) << type_name(i) << std::right
+                << std::setw(12) << counters.allocations[i] << '\n';
+
+            total += counters.allocations[i];
+        }
+
+        const std::size_t integers {counters.integer_cache_hits + counters.integer_cache_misses};
+        const std::size_t memo_calls {counters.memo_hits + counters.memo_misses};
+
+        stream << "    " << std::left << std::setw(20) << "total" << std::right << std::setw(12) << total << "\n\n"
+            << std::fixed << std::setprecision(2)
+            << "  interned integers   " << std::setw(12) << counters.integer_cache_hits << " of " << integers
+            << " (" << ratio(counters.integer_cache_hits, integers) * 100.0 << "% hit rate)\n"
+            << "  variable lookups    " << std::setw(12) << counters.environment_lookups
+            << " (" << ratio(counters.environment_depth, counters.environment_lookups) << " scopes on average)\n"
+            << "  function calls      " << std::setw(12) << counters.function_calls << '\n'
+            << "  method calls        " << std::setw(12) << counters.method_calls << '\n'
+            << "  builtin calls       " << std::setw(12) << counters.builtin_calls << '\n'
+            << "  struct instances    " << std::setw(12) << counters.struct_instantiations << '\n'
+            << "  returns             " << std::setw(12) << counters.returns << '\n'
+            << "  memoized results    " << std::setw(12) << counters.memo_hits << " of " << memo_calls
+            << " (" << ratio(counters.memo_hits, memo_calls) * 100.0 << "% hit rate)\n"
+            << "  peak live objects   " << std::setw(12) << counters.peak_live_objects << '\n';
+
+        stream.flags(flags);
+        stream.precision(precision);
+    }
+}
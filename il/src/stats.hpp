@@ -0,0 +1,67 @@
+#pragma once
+
+#include <ostream>
+#include <cstddef>
+
+// Runtime statistics counters, compiled in only with the IL_ENABLE_STATS definition
+// Every counting site is wrapped in IL_STATS(), which expands to nothing otherwise
+#ifdef IL_ENABLE_STATS
+    #define IL_STATS(statement) statement
+#else
+    #define IL_STATS(statement)
+#endif
+
+namespace stats {
+#ifdef IL_ENABLE_STATS
+    inline constexpr bool ENABLED {true};
+#else
+    inline constexpr bool ENABLED {false};
+#endif
+
+    inline constexpr std::size_t TYPES {17u};  // Number of object::Type values
+
+    struct Counters {
+        std::size_t allocations[TYPES] {};
+        std::size_t integer_cache_hits {};
+        std::size_t integer_cache_misses {};
+        std::size_t environment_lookups {};
+        std::size_t environment_depth {};  // Sum of the scopes walked by all lookups
+        std::size_t function_calls {};
+        std::size_t method_calls {};
+        std::size_t builtin_calls {};
+        std::size_t struct_instantiations {};
+        std::size_t returns {};
+        std::size_t memo_hits {};
+        std::size_t memo_misses {};
+        std::size_t live_objects {};
+        std::size_t peak_live_objects {};
+    };
+
+    // Every thread counts on its own, so the counters stay plain integers; the report shows the calling thread's
+    inline thread_local Counters counters;
+
+    template<typename T>
+    inline void allocated(T type) {
+        counters.allocations[static_cast<std::size_t>(type)]++;
+    }
+
+    inline void object_constructed() {
+        if (++counters.live_objects > counters.peak_live_objects) {
+            counters.peak_live_objects = counters.live_objects;
+        }
+    }
+
+    inline void object_destroyed() {
+        counters.live_objects--;
+    }
+
+    // Embedded in every object to keep track of how many are alive
+    struct Tracker {
+        Tracker() noexcept { object_constructed(); }
+        Tracker(const Tracker&) noexcept { object_constructed(); }
+        Tracker& operator=(const Tracker&) noexcept { return *this; }
+        ~Tracker() noexcept { object_destroyed(); }
+    };
+
+    void report(std::ostream& stream);
+}
@@ -0,0 +1,179 @@
+#include "table.hpp"
+
+#include <functional>
+#include <cstring>
+#include <utility>
+
+#include "object.hpp"
+
+namespace table {
+    static constexpr std::size_t NOT_FOUND {static_cast<std::size_t>(-1)};
+
+    std::size_t mix(std::size_t hash, std::uint64_t value) {
+        // From splitmix64
+        value += 0x9e3779b97f4a7c15ull + hash;
+        value = (value ^ (value >> 30u)) * 0xbf58476d1ce4e5b9ull;
+        value = (value ^ (value >> 27u)) * 0x94d049bb133111ebull;
+
+        return static_cast<std::size_t>(value ^ (value >> 31u));
+    }
+
+    bool hash(const object::Object& key, std::size_t& result) {
+        const std::size_t type {mix(0u, static_cast<std::uint64_t>(key.type))};
+
+        switch (key.type) {
+            case object::Type::None:
+                result = type;
+                return true;
+            case object::Type::Integer:
+                result = mix(type, static_cast<std::uint64_t>(static_cast<const object::Integer&>(key).value));
+                return true;
+            case object::Type::Float: {
+                double value {static_cast<const object::Float&>(key).value};
+                value = value == 0.0 ? 0.0 : value;  // Both zeros are equal, so they must hash the same
+
+                std::uint64_t bits {};
+                std::memcpy(&bits, &value, sizeof(bits));
+
+                result = mix(type, bits);
+                return true;
+            }
+            case object::Type::String:
+                result = mix(type, std::hash<std::string>()(static_cast<const object::String&>(key).value));
+                return true;
+            case object::Type::Boolean:
+                result = mix(type, static_cast<const object::Boolean&>(key).value ? 1u : 0u);
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    bool equal(const object::Object& left, const object::Object& right) {
+        if (left.type != right.type) {
+            return false;
+        }
+
+        switch (left.type) {
+            case object::Type::None:
+                return true;
+            case object::Type::Integer:
+                return static_cast<const object::Integer&>(left).value == static_cast<const object::Integer&>(right).value;
+            case object::Type::Float:
+                return static_cast<const object::Float&>(left).value == static_cast<const object::Float&>(right).value;
+            case object::Type::String:
+                return static_cast<const object::String&>(left).value == static_cast<const object::String&>(right).value;
+            case object::Type::Boolean:
+                return static_cast<const object::Boolean&>(left).value == static_cast<const object::Boolean&>(right).value;
+            default:
+                return false;
+        }
+    }
+
+    std::shared_ptr<object::Object>* Table::find(const object::Object& key, std::size_t hash) {
+        const std::size_t index {find_index(key, hash)};
+
+        return index != NOT_FOUND ? &entries[index].value : nullptr;
+    }
+
+    bool Table::insert(std::shared_ptr<object::Object> key, std::size_t hash, std::shared_ptr<object::Object> value) {
+        const std::size_t index {find_index(*key, hash)};
+
+        if (index != NOT_FOUND) {
+            entries[index].value = std::move(value);
+            return false;
+        }
+
+        // Keep the load factor under 7/8
+        if ((count + 1u) * 8u > entries.size() * 7u) {
+            grow();
+        }
+
+        place(Entry {std::move(key), std::move(value), hash, 1u});
+        count++;
+
+        return true;
+    }
+
+    bool Table::remove(const object::Object& key, std::size_t hash) {
+        std::size_t index {find_index(key, hash)};
+
+        if (index == NOT_FOUND) {
+            return false;
+        }
+
+        const std::size_t mask {entries.size() - 1u};
+
+        // Shift the following entries of the cluster back by one, so that no tombstones are needed
+        std::size_t next {(index + 1u) & mask};
+
+        while (entries[next].distance > 1u) {
+            entries[index] = std::move(entries[next]);
+            entries[index].distance--;
+
+            index = next;
+            next = (next + 1u) & mask;
+        }
+
+        entries[index] = Entry();
+        count--;
+
+        return true;
+    }
+
+    std::size_t Table::find_index(const object::Object& key, std::size_t hash) const {
+        if (entries.empty()) {
+            return NOT_FOUND;
+        }
+
+        const std::size_t mask {entries.size() - 1u};
+
+        std::size_t index {hash & mask};
+        std::size_t distance {1u};
+
+        // An entry closer to its home slot means that the key would have been placed before it
+        while (entries[index].distance >= distance) {
+            const Entry& entry {entries[index]};
+
+            if (entry.hash == hash && equal(*entry.key, key)) {
+                return index;
+            }
+
+            index = (index + 1u) & mask;
+            distance++;
+        }
+
+        return NOT_FOUND;
+    }
+
+    void Table::place(Entry&& entry) {
+        const std::size_t mask {entries.size() - 1u};
+
+        std::size_t index {entry.hash & mask};
+
+        while (entries[index].distance != 0u) {
+            // Take the slot from entries that are closer to their home slot
+            if (entries[index].distance < entry.distance) {
+                std::swap(entries[index], entry);
+            }
+
+            index = (index + 1u) & mask;
+            entry.distance++;
+        }
+
+        entries[index] = std::move(entry);
+    }
+
+    void Table::grow() {
+        std::vector<Entry> old_entries {std::move(entries)};
+
+        entries = std::vector<Entry>(old_entries.empty() ? INITIAL_CAPACITY : old_entries.size() * 2u);
+
+        for (Entry& entry : old_entries) {
+            if (entry.distance != 0u) {
+                entry.distance = 1u;
+                place(std::move(entry));
+            }
+        }
+    }
+}
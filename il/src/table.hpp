@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+
+namespace object {
+    struct Object;
+}
+
+namespace table {
+    std::size_t mix(std::size_t hash, std::uint64_t value);
+
+    // Only none, integers, floats, strings and booleans can be keys; returns false for the rest
+    bool hash(const object::Object& key, std::size_t& result);
+    bool equal(const object::Object& left, const object::Object& right);
+
+    // Open addressing hash table with Robin Hood hashing and backward shift deletion
+    // Entries live in a single array, so lookups usually touch just one or two cache lines
+    class Table {
+    public:
+        static constexpr std::size_t INITIAL_CAPACITY {8u};  // Power of two
+
+        struct Entry {
+            std::shared_ptr<object::Object> key;
+            std::shared_ptr<object::Object> value;  // Null in sets
+            std::size_t hash {};
+            std::size_t distance {};  // One more than the distance from the home slot; zero for empty slots
+        };
+
+        std::size_t size() const { return count; }
+
+        // Null when the key is not in the table
+        std::shared_ptr<object::Object>* find(const object::Object& key, std::size_t hash);
+
+        // Returns false if the key was already there, in which case only the value is replaced
+        bool insert(std::shared_ptr<object::Object> key, std::size_t hash, std::shared_ptr<object::Object> value);
+        bool remove(const object::Object& key, std::size_t hash);
+
+        template<typename F>
+        void for_each(F&& function) const {
+            for (const Entry& entry : entries) {
+                if (entry.distance != 0u) {
+                    function(entry.key, entry.value);
+                }
+            }
+        }
+    private:
+        std::size_t find_index(const object::Object& key, std::size_t hash) const;
+        void place(Entry&& entry);
+        void grow();
+
+        std::vector<Entry> entries;
+        std::size_t count {};
+    };
+}
@@ -0,0 +1,351 @@
+#include "tasks.hpp"
+
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <algorithm>
+#include <limits>
+#include <cstddef>
+
+#if defined(__unix__) || defined(__APPLE__)
+    #include <signal.h>
+    #include <pthread.h>
+#endif
+
+#include "environment.hpp"
+#include "transfer.hpp"
+
+namespace tasks {
+    static constexpr std::size_t NO_WORKER {std::numeric_limits<std::size_t>::max()};
+
+    // Index of the pool worker running on this thread; spares have none
+    static thread_local std::size_t worker_index {NO_WORKER};
+    static thread_local bool pool_thread {false};
+
+    static std::atomic<bool> g_stopping {false};
+
+    // Every worker has a queue of its own: it pushes and takes its newest tasks at the back, while idle threads
+    // steal the oldest ones from the front of the others
+    // Threads never run unrelated tasks while they wait, as a task stacked on top of a waiting one could wait for it
+    // in turn; instead, every worker that waits is covered by a spare thread
+    class Pool {
+    public:
+        Pool();
+        ~Pool() noexcept;
+
+        Pool(const Pool&) = delete;
+        Pool& operator=(const Pool&) = delete;
+
+        void submit(std::shared_ptr<Task> task);
+
+        // Runs the task on the calling thread if nobody has started it yet, otherwise waits for it
+        void join(Task& task);
+
+        void block();
+        void unblock();
+    private:
+        struct Queue {
+            std::mutex mutex;
+            std::deque<std::shared_ptr<Task>> tasks;
+        };
+
+        std::shared_ptr<Task> take(std::size_t own);
+        std::shared_ptr<Task> pop(Queue& queue, bool newest);
+        void run(Task& task);
+        void work(std::size_t index);
+
+        std::vector<std::unique_ptr<Queue>> queues;
+        std::vector<std::thread> threads;  // The workers, then the spares
+
+        std::mutex mutex;
+        std::condition_variable work_available;
+        std::condition_variable task_done;
+        std::atomic<std::size_t> pending {0u};  // Queued tasks, including the ones that were joined meanwhile
+        std::atomic<std::size_t> next_queue {0u};  // Round robin for tasks spawned outside of the workers
+        std::size_t blocked {0u};
+        std::size_t spares {0u};
+        bool stopping {false};
+    };
+
+    Pool::Pool() {
+        const unsigned int size {std::max(std::thread::hardware_concurrency(), 1u)};
+
+        for (unsigned int i {0u}; i < size; i++) {
+            queues.push_back(std::make_unique<Queue>());
+        }
+
+        for (unsigned int i {0u}; i < size; i++) {
+            threads.emplace_back(&Pool::work, this, static_cast<std::size_t>(i));
+        }
+    }
+
+    // Tasks that were never joined are dropped; the ones still running are waited for
+    Pool::~Pool() noexcept {
+        {
+            std::lock_guard<std::mutex> lock {mutex};
+            stopping = true;
+        }
+
+        g_stopping = true;
+        work_available.notify_all();
+
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+    }
+
+    void Pool::submit(std::shared_ptr<Task> task) {
+        const std::size_t index {
+            worker_index != NO_WORKER ? worker_index : next_queue.fetch_add(1u, std::memory_order_relaxed) % queues.size()
+        };
+
+        {
+            std::lock_guard<std::mutex> lock {queues[index]->mutex};
+            queues[index]->tasks.push_back(std::move(task));
+        }
+
+        {
+            std::lock_guard<std::mutex> lock {mutex};
+            pending++;
+        }
+
+        work_available.notify_one();
+    }
+
+    void Pool::join(Task& task) {
+        if (!task.started.exchange(true)) {
+            run(task);
+            return;
+        }
+
+        if (task.done) {
+            return;
+        }
+
+        Blocking blocking;
+
+        std::unique_lock<std::mutex> lock {mutex};
+        task_done.wait(lock, [&task]() { return task.done.load(); });
+    }
+
+    void Pool::block() {
+        std::lock_guard<std::mutex> lock {mutex};
+
+        if (++blocked > spares && !stopping) {
+            spares++;
+            threads.emplace_back(&Pool::work, this, NO_WORKER);
+        }
+    }
+
+    void Pool::unblock() {
+        std::lock_guard<std::mutex> lock {mutex};
+        blocked--;
+    }
+
+    std::shared_ptr<Task> Pool::take(std::size_t own) {
+        if (own != NO_WORKER) {
+            std::shared_ptr<Task> task {pop(*queues[own], true)};
+
+            if (task != nullptr) {
+                return task;
+            }
+        }
+
+        const std::size_t first {own != NO_WORKER ? own + 1u : 0u};
+
+        for (std::size_t i {0u}; i < queues.size(); i++) {
+            std::shared_ptr<Task> task {pop(*queues[(first + i) % queues.size()], false)};
+
+            if (task != nullptr) {
+                return task;
+            }
+        }
+
+        return nullptr;
+    }
+
+    std::shared_ptr<Task> Pool::pop(Queue& queue, bool newest) {
+        std::lock_guard<std::mutex> lock {queue.mutex};
+
+        while (!queue.tasks.empty()) {
+            std::shared_ptr<Task> task;
+
+            if (newest) {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+            } else {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+            }
+
+            pending--;
+
+            // Joining threads run the tasks they join if they get to them first
+            if (!task->started.exchange(true)) {
+                return task;
+            }
+        }
+
+        return nullptr;
+    }
+
+    void Pool::run(Task& task) {
+        task.run();
+
+        {
+            std::lock_guard<std::mutex> lock {mutex};
+            task.done = true;
+        }
+
+        task_done.notify_all();
+    }
+
+    void Pool::work(std::size_t index) {
+        worker_index = index;
+        pool_thread = true;
+
+#if defined(__unix__) || defined(__APPLE__)
+        // The sampling profiler's handler reads the shadow stack of the interpreter that started it, so it must never
+        // run on the threads of tasks
+        sigset_t signals;
+        sigemptyset(&signals);
+        sigaddset(&signals, SIGPROF);
+        pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+#endif
+
+        while (true) {
+            std::shared_ptr<Task> task {take(index)};
+
+            if (task != nullptr) {
+                run(*task);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock {mutex};
+            work_available.wait(lock, [this]() { return stopping || pending > 0u; });
+
+            if (stopping) {
+                return;
+            }
+        }
+    }
+
+    // Started by the first spawn
+    static Pool& pool() {
+        static Pool pool;
+
+        return pool;
+    }
+
+    // Other threads don't take tasks, so they don't need covering
+    Blocking::Blocking() {
+        if (pool_thread) {
+            pool().block();
+        }
+    }
+
+    Blocking::~Blocking() noexcept {
+        if (pool_thread) {
+            pool().unblock();
+        }
+    }
+
+    Task::Task(
+        Interpreter& spawner,
+        const std::shared_ptr<object::Object>& callee,
+        const std::vector<std::shared_ptr<object::Object>>& arguments,
+        const token::Token& token
+    )
+        : ctx(&errors), interpreter(std::make_unique<Interpreter>(&ctx, &output, &input)), token(token) {
+        interpreter->set_arguments(spawner.get_arguments());
+
+        // Host functions and values of embedders are builtins too
+        for (const auto& [name, builtin] : spawner.get_builtins()) {
+            if (interpreter->get_builtin(name) == nullptr) {
+                interpreter->define_builtin(name, builtin);
+            }
+        }
+
+        transfer::Copier copier {*interpreter, token};
+        Environment& globals {interpreter->get_global_environment()};
+
+        // Global variables holding mutable objects are left out; copying them for every task would be too costly,
+        // so they are passed as arguments instead, and using them from the task says so
+        // Channels are shared, so every task can reach them
+        for (const auto& [name, value] : spawner.get_global_environment().get_values()) {
+            if (value == nullptr || value == spawner.get_builtin(name)) {
+                continue;
+            }
+
+            const bool code {value->type == object::Type::Function || value->type == object::Type::Struct};
+
+            if (code || value->type == object::Type::Channel || transfer::immutable(*value)) {
+                globals.define(name, copier.copy(value));
+            } else {
+                globals.leave_out(name, "Global `" + name + "` holds a mutable value; pass it to spawn() as an argument");
+            }
+        }
+
+        this->callee = copier.copy(callee);
+
+        // Methods get their instance first, as in any call
+        if (this->callee->type == object::Type::Method) {
+            this->arguments.push_back(object::cast<object::Method>(this->callee)->instance);
+        }
+
+        for (const auto& argument : arguments) {
+            this->arguments.push_back(copier.copy(argument));
+        }
+    }
+
+    void Task::run() {
+        try {
+            result = object::as_callable(callee)->call(interpreter.get(), arguments, token);
+        } catch (const RuntimeError& e) {
+            error = e;
+        }
+
+        interpreter->get_output().flush();
+
+        callee = nullptr;
+        arguments.clear();
+    }
+
+    std::shared_ptr<object::Object> Task::join(Interpreter& joiner, const token::Token& token) {
+        if (!joined) {
+            pool().join(*this);
+
+            joined = true;
+            joiner.get_output().write(output.str());
+
+            if (!error) {
+                try {
+                    result = transfer::Copier(joiner, token).copy(result);
+                } catch (const RuntimeError& e) {
+                    error = e;
+                    result = nullptr;
+                }
+            }
+
+            interpreter.reset();
+        }
+
+        if (error) {
+            throw RuntimeError(
+                token,
+                "Spawned task failed at line " + std::to_string(error->token.get_line()) + ": " + error->message
+            );
+        }
+
+        return result;
+    }
+
+    void submit(std::shared_ptr<Task> task) {
+        pool().submit(std::move(task));
+    }
+
+    bool stopping() {
+        return g_stopping;
+    }
+}
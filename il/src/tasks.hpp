@@ -0,0 +1,68 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <optional>
+#include <atomic>
+#include <sstream>
+
+#include "object.hpp"
+#include "token.hpp"
+#include "context.hpp"
+#include "interpreter.hpp"
+#include "runtime_error.hpp"
+
+// Function calls spawned from scripts, running on a process-wide work-stealing thread pool
+// Every task has an interpreter and a heap of its own; values go in and out through transfer::Copier
+namespace tasks {
+    class Task {
+    public:
+        // Copies the callee, the arguments and the functions, structs and immutable globals the call may use out of
+        // the spawning interpreter; the arity must have been checked already
+        Task(
+            Interpreter& spawner,
+            const std::shared_ptr<object::Object>& callee,
+            const std::vector<std::shared_ptr<object::Object>>& arguments,
+            const token::Token& token
+        );
+
+        // Waits for the task to finish, or runs it if it hasn't started yet, then writes its output to the joining
+        // interpreter's and returns a copy of its result; joining again returns the same result
+        std::shared_ptr<object::Object> join(Interpreter& joiner, const token::Token& token);
+    private:
+        void run();
+
+        std::ostringstream output;
+        std::ostringstream errors;
+        std::istringstream input;  // Tasks get no input
+        Context ctx;
+        std::unique_ptr<Interpreter> interpreter;  // Released once joined
+
+        std::shared_ptr<object::Object> callee;
+        std::vector<std::shared_ptr<object::Object>> arguments;
+        token::Token token;
+
+        std::shared_ptr<object::Object> result;
+        std::optional<RuntimeError> error;
+        std::atomic<bool> started {false};
+        std::atomic<bool> done {false};
+        bool joined {false};
+
+        friend class Pool;
+    };
+
+    void submit(std::shared_ptr<Task> task);
+
+    // Held by threads while they wait for other threads; a pool thread that waits is covered by a spare one meanwhile
+    class Blocking {
+    public:
+        Blocking();
+        ~Blocking() noexcept;
+
+        Blocking(const Blocking&) = delete;
+        Blocking& operator=(const Blocking&) = delete;
+    };
+
+    // True once the process is exiting; threads waiting for others should give up
+    bool stopping();
+}
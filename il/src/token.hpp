@@ -18,10 +18,10 @@ namespace token {
         Identifier, String, Integer, Float,
 
         // Parentheses
-        LeftParen, RightParen, LeftBrace, RightBrace,
+        LeftParen, RightParen, LeftBrace, RightBrace, LeftBracket, RightBracket,
 
         // Punctuation
-        Comma, Dot, Semicolon,
+        Comma, Dot, Semicolon, Colon,
 
         // Math operators
         Minus, Plus, Slash, Star,
@@ -30,7 +30,7 @@ namespace token {
         BangEqual, Greater, GreaterEqual, Less, LessEqual, EqualEqual,
 
         // Keywords
-        Let, True, False, None, Or, And, Not, If, Else, While, For, Fun, Return, Struct,
+        Let, True, False, None, Or, And, Not, If, Else, While, For, Fun, Return, Struct, Memo, In,
 
         // Other
         Equal,
@@ -81,15 +81,15 @@ namespace token {
 
         "Identifier"sv, "String"sv, "Integer"sv, "Float"sv,
 
-        "LeftParen"sv, "RightParen"sv, "LeftBrace"sv, "RightBrace"sv,
+        "LeftParen"sv, "RightParen"sv, "LeftBrace"sv, "RightBrace"sv, "LeftBracket"sv, "RightBracket"sv,
 
-        "Comma"sv, "Dot"sv, "Semicolon"sv,
+        "Comma"sv, "Dot"sv, "Semicolon"sv, "Colon"sv,
 
         "Minus"sv, "Plus"sv, "Slash"sv, "Star"sv,
 
         "BangEqual"sv, "Greater"sv, "GreaterEqual"sv, "Less"sv, "LessEqual"sv, "EqualEqual"sv,
 
-        "Let"sv, "True"sv, "False"sv, "None"sv, "Or"sv, "And"sv, "Not"sv, "If"sv, "Else"sv, "While"sv, "For"sv, "Fun"sv, "Return"sv, "Struct"sv,
+        "Let"sv, "True"sv, "False"sv, "None"sv, "Or"sv, "And"sv, "Not"sv, "If"sv, "Else"sv, "While"sv, "For"sv, "Fun"sv, "Return"sv, "Struct"sv, "Memo"sv, "In"sv,
 
         "Equal"sv
     };
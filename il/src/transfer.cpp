@@ -0,0 +1,167 @@
+#include "transfer.hpp"
+
+#include <vector>
+#include <cstddef>
+
+#include "interpreter.hpp"
+#include "runtime_error.hpp"
+
+namespace transfer {
+    bool immutable(const object::Object& object) {
+        switch (object.type) {
+            case object::Type::None:
+            case object::Type::String:
+            case object::Type::Integer:
+            case object::Type::Float:
+            case object::Type::Boolean:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    std::shared_ptr<object::Object> Copier::copy(const std::shared_ptr<object::Object>& object) {
+        if (object == nullptr || immutable(*object)) {
+            return object;
+        }
+
+        const auto iter {copies.find(object.get())};
+
+        if (iter != copies.cend()) {
+            return iter->second;
+        }
+
+        // Every copy is recorded before copying what it references, so that cycles end at the copy
+        switch (object->type) {
+            case object::Type::BuiltinFunction: {
+                auto builtin {target->get_builtin(object::cast<object::BuiltinFunction>(object)->name)};
+
+                return copies[object.get()] = builtin;
+            }
+            case object::Type::Function: {
+                auto function {object::cast<object::Function>(object)};
+
+                // Memoized functions start with an empty cache of their own
+                return copies[object.get()] = object::create_function(
+                    function->name,
+                    function->parameters,
+                    function->body,
+                    function->memo != nullptr,
+                    function->lazy
+                );
+            }
+            case object::Type::Method:
+                return copy_method(object::cast<object::Method>(object));
+            case object::Type::Struct: {
+                auto struct_ {object::cast<object::Struct>(object)};
+
+                std::unordered_map<std::string, std::shared_ptr<object::Method>> methods;
+
+                for (const auto& [name, method] : struct_->methods) {
+                    methods[name] = object::cast<object::Method>(
+                        object::create_method(method->name, method->parameters, method->body, method->lazy)
+                    );
+                }
+
+                return copies[object.get()] = object::create_struct(struct_->name, methods);
+            }
+            case object::Type::StructInstance: {
+                auto instance {object::cast<object::StructInstance>(object)};
+                auto struct_ {object::cast<object::Struct>(copy(instance->struct_))};
+
+                auto result {object::cast<object::StructInstance>(object::create_struct_instance(struct_))};
+                copies[object.get()] = result;
+
+                for (auto& [_, method] : result->methods) {
+                    method->instance = result;
+                }
+
+                for (const auto& [name, field] : instance->fields) {
+                    result->fields[name] = copy(field);
+                }
+
+                return result;
+            }
+            case object::Type::Array: {
+                auto array {object::cast<object::Array>(object)};
+
+                auto result {object::cast<object::Array>(object::create_array({}))};
+                copies[object.get()] = result;
+
+                result->elements.reserve(array->elements.size());
+
+                for (const auto& element : array->elements) {
+                    result->elements.push_back(copy(element));
+                }
+
+                return result;
+            }
+            case object::Type::Map: {
+                auto result {object::cast<object::Map>(object::create_map())};
+                copies[object.get()] = result;
+
+                // Keys are immutable, so only the values need copying
+                object::cast<object::Map>(object)->entries.for_each(
+                    [&](const std::shared_ptr<object::Object>& key, const std::shared_ptr<object::Object>& value) {
+                        std::size_t hash {};
+                        table::hash(*key, hash);
+
+                        result->entries.insert(key, hash, copy(value));
+                    }
+                );
+
+                return result;
+            }
+            case object::Type::Set: {
+                auto result {object::cast<object::Set>(object::create_set())};
+                copies[object.get()] = result;
+
+                object::cast<object::Set>(object)->elements.for_each(
+                    [&](const std::shared_ptr<object::Object>& element, const std::shared_ptr<object::Object>&) {
+                        std::size_t hash {};
+                        table::hash(*element, hash);
+
+                        result->elements.insert(element, hash, nullptr);
+                    }
+                );
+
+                return result;
+            }
+            case object::Type::IntArray: {
+                std::vector<long long> values {object::cast<object::IntArray>(object)->values};
+
+                return copies[object.get()] = object::create_int_array(std::move(values));
+            }
+            case object::Type::FloatArray: {
+                std::vector<double> values {object::cast<object::FloatArray>(object)->values};
+
+                return copies[object.get()] = object::create_float_array(std::move(values));
+            }
+            case object::Type::Task:
+                throw RuntimeError(*token, "Task handles cannot be passed to or returned from tasks");
+            case object::Type::Channel:
+                return copies[object.get()] = object::create_channel(object::cast<object::Channel>(object)->channel);
+            default:
+                return object;  // Immutable
+        }
+    }
+
+    std::shared_ptr<object::Object> Copier::copy_method(const std::shared_ptr<object::Method>& method) {
+        std::shared_ptr<object::Object> instance {copy(method->instance)};
+
+        // A method taken from an instance is the same method as the instance's copy has
+        if (instance != nullptr && instance->type == object::Type::StructInstance) {
+            auto& methods {object::cast<object::StructInstance>(instance)->methods};
+            const auto iter {methods.find(method->name.get_lexeme())};
+
+            if (iter != methods.cend()) {
+                return copies[method.get()] = iter->second;
+            }
+        }
+
+        auto result {object::cast<object::Method>(object::create_method(method->name, method->parameters, method->body, method->lazy))};
+        result->instance = instance;
+
+        return copies[method.get()] = result;
+    }
+}
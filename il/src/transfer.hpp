@@ -0,0 +1,33 @@
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+
+#include "object.hpp"
+#include "token.hpp"
+
+class Interpreter;
+
+// Moving values between interpreters running on different threads, which must never share mutable objects
+namespace transfer {
+    // None, numbers, booleans and strings are never modified after creation, so they can be shared
+    bool immutable(const object::Object& object);
+
+    // Copies objects into the heap of the target interpreter; immutable objects are shared instead and everything
+    // else is copied deeply, keeping cycles and objects referenced more than once intact
+    // Channels are the exception: the copy refers to the same channel
+    class Copier {
+    public:
+        // Errors are reported at the given token
+        Copier(const Interpreter& target, const token::Token& token)
+            : target(&target), token(&token) {}
+
+        std::shared_ptr<object::Object> copy(const std::shared_ptr<object::Object>& object);
+    private:
+        std::shared_ptr<object::Object> copy_method(const std::shared_ptr<object::Method>& method);
+
+        const Interpreter* target {nullptr};
+        const token::Token* token {nullptr};
+        std::unordered_map<const object::Object*, std::shared_ptr<object::Object>> copies;
+    };
+}
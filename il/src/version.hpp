@@ -0,0 +1,5 @@
+#pragma once
+
+inline constexpr unsigned int VERSION_MAJOR {0u};
+inline constexpr unsigned int VERSION_MINOR {1u};
+inline constexpr unsigned int VERSION_PATCH {0u};
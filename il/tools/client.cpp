@@ -0,0 +1,73 @@
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <filesystem>
+#include <cstring>
+
+#include <unistd.h>
+
+#include "protocol.hpp"
+
+// Runs a script on a server started with `il --serve`, as if it ran here
+static int usage() {
+    std::cerr << "usage: il_client [--source] <socket> <file or source> [argument...]\n";
+
+    return 1;
+}
+
+int main(int argc, char** argv) {
+    int i {1};
+    bool source {false};
+
+    if (i < argc && std::strcmp(argv[i], "--source") == 0) {
+        source = true;
+        i++;
+    }
+
+    if (argc - i < 2) {
+        return usage();
+    }
+
+    const std::string socket_path {argv[i++]};
+    std::string script {argv[i++]};
+    const std::vector<std::string> arguments (argv + i, argv + argc);
+
+    // The server may run in another directory
+    if (!source) {
+        std::error_code code;
+        const std::filesystem::path path {std::filesystem::absolute(script, code)};
+
+        if (!code) {
+            script = path.string();
+        }
+    }
+
+    const int descriptor {protocol::connect(socket_path)};
+
+    if (descriptor < 0) {
+        std::cerr << "il_client: could not connect to `" << socket_path << "`\n";
+        return 1;
+    }
+
+    const protocol::Frame type {source ? protocol::Frame::Source : protocol::Frame::File};
+    int status {1};
+
+    const bool done {
+        protocol::send_request(descriptor, type, script, arguments)
+            && protocol::read_response(descriptor, status, [](protocol::Frame type, std::string_view written) {
+                std::ostream& stream {type == protocol::Frame::Output ? std::cout : std::cerr};
+                stream.write(written.data(), static_cast<std::streamsize>(written.size()));
+                stream.flush();
+            })
+    };
+
+    ::close(descriptor);
+
+    if (!done) {
+        std::cerr << "il_client: the connection was lost\n";
+        return 1;
+    }
+
+    return status;
+}
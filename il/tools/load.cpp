@@ -0,0 +1,179 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <filesystem>
+#include <algorithm>
+#include <cstring>
+#include <cstddef>
+
+#include <unistd.h>
+
+#include "protocol.hpp"
+#include "numeric.hpp"
+
+// Sends the same request to a server started with `il --serve` over and over, from several connections at the same
+// time, then reports the throughput and the latency percentiles
+static int usage() {
+    std::cerr << "usage: il_load [--connections <n>] [--requests <n>] [--source] <socket> <file or source> [argument...]\n";
+
+    return 1;
+}
+
+struct Connection {
+    std::size_t requests {0u};
+    std::size_t failed {0u};  // Nonzero exit status
+    bool lost {false};
+    std::vector<double> latencies;
+};
+
+static void run_connection(
+    const std::string& socket_path,
+    protocol::Frame type,
+    const std::string& script,
+    const std::vector<std::string>& arguments,
+    Connection& connection
+) {
+    const int descriptor {protocol::connect(socket_path)};
+
+    if (descriptor < 0) {
+        connection.lost = true;
+        return;
+    }
+
+    connection.latencies.reserve(connection.requests);
+
+    for (std::size_t i {0u}; i < connection.requests; i++) {
+        const auto start {std::chrono::steady_clock::now()};
+        int status {1};
+
+        const bool done {
+            protocol::send_request(descriptor, type, script, arguments)
+                && protocol::read_response(descriptor, status, [](protocol::Frame, std::string_view) {})
+        };
+
+        if (!done) {
+            connection.lost = true;
+            break;
+        }
+
+        const auto end {std::chrono::steady_clock::now()};
+
+        connection.latencies.push_back(std::chrono::duration<double>(end - start).count());
+
+        if (status != 0) {
+            connection.failed++;
+        }
+    }
+
+    ::close(descriptor);
+}
+
+static double percentile(const std::vector<double>& sorted, double fraction) {
+    const auto index {static_cast<std::size_t>(fraction * static_cast<double>(sorted.size() - 1u))};
+
+    return sorted[index] * 1000.0;
+}
+
+static bool parse_count(const char* string, long long& result) {
+    if (numeric::parse(string, result) != numeric::Error::None || result < 1ll) {
+        std::cerr << "il_load: invalid number `" << string << "`\n";
+        return false;
+    }
+
+    return true;
+}
+
+int main(int argc, char** argv) {
+    int i {1};
+    long long connections {4ll};
+    long long requests {1000ll};
+    bool source {false};
+
+    for (; i < argc && argv[i][0u] == '-'; i++) {
+        const bool has_value {i + 1 < argc};
+
+        if (std::strcmp(argv[i], "--connections") == 0 && has_value) {
+            if (!parse_count(argv[++i], connections)) {
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--requests") == 0 && has_value) {
+            if (!parse_count(argv[++i], requests)) {
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--source") == 0) {
+            source = true;
+        } else {
+            return usage();
+        }
+    }
+
+    if (argc - i < 2) {
+        return usage();
+    }
+
+    const std::string socket_path {argv[i++]};
+    std::string script {argv[i++]};
+    const std::vector<std::string> arguments (argv + i, argv + argc);
+
+    if (!source) {
+        std::error_code code;
+        const std::filesystem::path path {std::filesystem::absolute(script, code)};
+
+        if (!code) {
+            script = path.string();
+        }
+    }
+
+    const protocol::Frame type {source ? protocol::Frame::Source : protocol::Frame::File};
+
+    // The requests are spread evenly over the connections
+    std::vector<Connection> results (static_cast<std::size_t>(connections));
+
+    for (std::size_t j {0u}; j < results.size(); j++) {
+        results[j].requests = static_cast<std::size_t>(requests) / results.size()
+            + (j < static_cast<std::size_t>(requests) % results.size() ? 1u : 0u);
+    }
+
+    const auto start {std::chrono::steady_clock::now()};
+
+    std::vector<std::thread> threads;
+
+    for (Connection& connection : results) {
+        threads.emplace_back(run_connection, std::cref(socket_path), type, std::cref(script), std::cref(arguments), std::ref(connection));
+    }
+
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    const double seconds {std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()};
+
+    std::vector<double> latencies;
+    std::size_t failed {0u};
+    std::size_t lost {0u};
+
+    for (const Connection& connection : results) {
+        latencies.insert(latencies.end(), connection.latencies.cbegin(), connection.latencies.cend());
+        failed += connection.failed;
+        lost += connection.lost ? 1u : 0u;
+    }
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << latencies.size() << " requests, " << connections << " connections, " << failed << " failed, "
+        << lost << " lost, " << seconds * 1000.0 << " ms, " << std::setprecision(1)
+        << static_cast<double>(latencies.size()) / seconds << " requests/s\n";
+
+    if (!latencies.empty()) {
+        std::sort(latencies.begin(), latencies.end());
+
+        std::cout << std::setprecision(3) << "latency: p50 " << percentile(latencies, 0.5) << " ms, p90 "
+            << percentile(latencies, 0.9) << " ms, p99 " << percentile(latencies, 0.99) << " ms, max "
+            << latencies.back() * 1000.0 << " ms\n";
+    }
+
+    return failed == 0u && lost == 0u ? 0 : 1;
+}